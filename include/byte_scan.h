@@ -0,0 +1,78 @@
+#ifndef BYTE_SCAN_H_
+#define BYTE_SCAN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BYTE_SCAN_X86 1
+#endif
+
+// ================ 向量化的单字节查找 =================
+// 与 memchr() 语义相同，用于分隔符模式下在接收缓冲中查找电文结束符。
+// 每次比较 16（SSE2）或 32（AVX2，运行时检测）字节，命中时由比较掩码的最低位得到偏移；
+// 不足一个向量的尾部逐字节比较，不会读到 [p, p + n) 之外。非 x86 平台使用逐字节的实现。
+
+typedef const char* (*ByteScanFn)(const char* p, size_t n, char c);
+
+// 逐字节的实现，用于非 x86 平台与向量实现的尾部
+static inline const char* scan_byte_scalar(const char* p, size_t n, char c) {
+    for (size_t i = 0; i < n; i++) {
+        if (p[i] == c) return p + i;
+    }
+    return NULL;
+}
+
+#ifdef BYTE_SCAN_X86
+static inline const char* scan_byte_sse2(const char* p, size_t n, char c) {
+    __m128i needle = _mm_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(p + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, needle));
+        if (mask != 0) return p + i + __builtin_ctz(mask);
+    }
+    return scan_byte_scalar(p + i, n - i, c);
+}
+
+// 每轮比较 64 字节，两个掩码合并后只判断一次，多 KB 的电文体大部分时间在这个循环中
+__attribute__((target("avx2")))
+static inline const char* scan_byte_avx2(const char* p, size_t n, char c) {
+    __m256i needle = _mm256_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), needle);
+        __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + 32)), needle);
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_or_si256(a, b))) {
+            uint64_t mask = (uint32_t)_mm256_movemask_epi8(a) |
+                            ((uint64_t)(uint32_t)_mm256_movemask_epi8(b) << 32);
+            return p + i + __builtin_ctzll(mask);
+        }
+    }
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(p + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, needle));
+        if (mask != 0) return p + i + __builtin_ctz(mask);
+    }
+    return scan_byte_scalar(p + i, n - i, c);
+}
+#endif
+
+// 按 CPU 支持的指令集选择实现，进程内只检测一次
+static inline ByteScanFn select_byte_scanner() {
+#ifdef BYTE_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return scan_byte_avx2;
+    return scan_byte_sse2;
+#else
+    return scan_byte_scalar;
+#endif
+}
+
+// 在 [p, p + n) 中查找第一个等于 c 的字节，找不到时返回 NULL
+static inline const char* scan_byte(const char* p, size_t n, char c) {
+    static const ByteScanFn scanner = select_byte_scanner();
+    return scanner(p, n, c);
+}
+
+#endif // BYTE_SCAN_H_
@@ -0,0 +1,69 @@
+#ifndef DATETIME_CACHE_H_
+#define DATETIME_CACHE_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// ================ 电文头日期时间与定长数字的快速格式化 =================
+// 每个线程缓存当前这一秒的 "YYYYMMDDHHMMSS"，秒数变化时才调用一次 localtime_r() 重新格式化，
+// 其余时候只需一次 CLOCK_REALTIME_COARSE 读时钟（vDSO，不进入内核）和两次拷贝。
+// 定长十进制数字通过两位一组的查表写出，不调用 snprintf，也没有依赖数值的分支。
+
+// "00" ~ "99" 两位数字表
+static const char DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// 写出 0 ~ 99 的两位数字
+static inline void write_2digits(char* out, unsigned v) {
+    memcpy(out, &DIGIT_PAIRS[v * 2], 2);
+}
+
+// 写出 0 ~ 9999 的四位数字，不足四位补 0
+static inline void write_4digits(char* out, unsigned v) {
+    unsigned hi = (v * 5243) >> 19;     // v / 100，对 v < 43699 精确
+    write_2digits(out, hi);
+    write_2digits(out + 2, v - hi * 100);
+}
+
+// 写出 0 ~ 999999 的六位数字，不足六位补 0
+static inline void write_6digits(char* out, unsigned v) {
+    unsigned hi = v / 10000;            // 除以常数由编译器换成乘法与移位
+    write_2digits(out, hi);
+    write_4digits(out + 2, v - hi * 10000);
+}
+
+struct DateTimeCache {
+    time_t second;          // 缓存对应的秒，-1 表示尚未填充
+    char digits[14];        // YYYYMMDDHHMMSS
+};
+
+// 当前线程的日期时间缓存，超过一秒未刷新时重新格式化
+static inline const DateTimeCache& datetime_now() {
+    thread_local DateTimeCache cache = {-1, {}};
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    if (ts.tv_sec != cache.second) {
+        struct tm t;
+        localtime_r(&ts.tv_sec, &t);
+        write_4digits(cache.digits, (unsigned)(t.tm_year + 1900));
+        write_2digits(cache.digits + 4, (unsigned)(t.tm_mon + 1));
+        write_2digits(cache.digits + 6, (unsigned)t.tm_mday);
+        write_2digits(cache.digits + 8, (unsigned)t.tm_hour);
+        write_2digits(cache.digits + 10, (unsigned)t.tm_min);
+        write_2digits(cache.digits + 12, (unsigned)t.tm_sec);
+        cache.second = ts.tv_sec;
+    }
+    return cache;
+}
+
+#endif // DATETIME_CACHE_H_
@@ -0,0 +1,280 @@
+#ifndef HEAD_TRAITS_H_
+#define HEAD_TRAITS_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include "msghead.h"
+
+// ================ 编译期电文头格式描述 =================
+// 各厂的电文头格式不同：长度字段可能是十进制字符或二进制整数、位于电文头的不同位置，
+// 长度可能包括或不包括电文头、结束符。HeadLayout 在编译期描述这些差异，
+// FrameCodec 据此生成长度字段的解码与编码代码，收发路径对每条电文不再有按格式判断的分支。
+// 不发送长度的老旧对端使用 DelimitedLayout：没有电文头，每条电文以一个分隔符结束。
+// 程序使用哪一种格式由 socket_comm.cpp 中的 WIRE_HEAD_TRAITS 决定。
+
+// 电文头中的分片标记
+struct FragmentInfo {
+    int id;         // 分片消息号，同一条大消息的各分片相同
+    int index;      // 分片序号，从 0 开始
+    bool last;      // 是否为最后一片
+};
+
+// 长度字段的编码方式
+enum LengthEncoding {
+    LENGTH_DECIMAL,     // 定长十进制字符，不足位补 '0'
+    LENGTH_BINARY_BE,   // 无符号大端整数（网络字节序）
+    LENGTH_BINARY_LE,   // 无符号小端整数
+};
+
+// width 位十进制数的最大值
+static constexpr long decimal_max(int width) {
+    return width == 0 ? 0 : decimal_max(width - 1) * 10 + 9;
+}
+
+// 电文头格式：Head 为电文头结构，长度字段位于 LengthOffset 处，占 LengthWidth 字节
+// IncludesHeader、IncludesTerminator 指示长度是否包括电文头、TerminatorLength 字节的结束符
+// 带结束符的格式须重新定义 terminator() 返回结束符；发送时在电文体后追加，接收时去掉，
+// check_terminator 为 true 时接收方还校验结束符，不符时按电文非法处理
+// 派生的格式可以重新定义 decode_length()、init_template()、stamp() 以处理电文头的其他字段；
+// 电文头能标记分片的格式还需定义 supports_fragments 等常量与 stamp_fragment()、parse_fragment()
+template <typename Head, int LengthOffset, int LengthWidth, LengthEncoding Encoding,
+          bool IncludesHeader, bool IncludesTerminator, int TerminatorLength = 0>
+struct HeadLayout {
+    typedef Head head_type;
+    static constexpr int head_length = sizeof(Head);
+    static constexpr int length_offset = LengthOffset;
+    static constexpr int length_width = LengthWidth;
+    static constexpr LengthEncoding length_encoding = Encoding;
+    static constexpr bool includes_header = IncludesHeader;
+    static constexpr bool includes_terminator = IncludesTerminator;
+    static constexpr int terminator_length = TerminatorLength;
+    static constexpr bool check_terminator = true;
+    static constexpr bool delimited = false;
+    static constexpr char delimiter = '\0';    // 只在分隔符模式下使用
+    // 默认不支持分片，超过一条电文的消息拆分为互相独立的电文
+    static constexpr bool supports_fragments = false;
+    static constexpr int max_fragments = 1;     // 一条消息最多的分片数
+    static constexpr int fragment_ids = 1;      // 分片消息号的取值个数，循环使用
+
+    static_assert(LengthOffset >= 0 && LengthOffset + LengthWidth <= (int)sizeof(Head), "长度字段须位于电文头内");
+    static_assert(LengthWidth > 0 && LengthWidth <= (Encoding == LENGTH_DECIMAL ? 9 : 4), "长度字段宽度超出范围");
+
+    // 长度字段能表示的最大值
+    static constexpr long max_length_value =
+        Encoding == LENGTH_DECIMAL ? decimal_max(LengthWidth) : (long)((1ULL << (8 * LengthWidth)) - 1);
+    // 长度字段中不属于电文体的字节数
+    static constexpr int length_overhead = (IncludesHeader ? head_length : 0) +
+                                           (IncludesTerminator ? TerminatorLength : 0);
+
+    // 解码长度字段，十进制字段含非数字字符时返回 -1
+    static inline long decode_length(const char* head) {
+        const unsigned char* p = (const unsigned char*)head + LengthOffset;
+        long value = 0;
+        if constexpr (Encoding == LENGTH_DECIMAL) {
+            for (int i = 0; i < LengthWidth; i++) {
+                unsigned d = p[i] - (unsigned)'0';
+                if (d > 9) return -1;
+                value = value * 10 + d;
+            }
+        } else if constexpr (Encoding == LENGTH_BINARY_BE) {
+            for (int i = 0; i < LengthWidth; i++) value = (value << 8) | p[i];
+        } else {
+            for (int i = LengthWidth - 1; i >= 0; i--) value = (value << 8) | p[i];
+        }
+        return value;
+    }
+
+    // 把 value 写入长度字段，调用方保证不超过 max_length_value
+    static inline void encode_length(char* head, long value) {
+        unsigned char* p = (unsigned char*)head + LengthOffset;
+        if constexpr (Encoding == LENGTH_DECIMAL) {
+            for (int i = LengthWidth - 1; i >= 0; i--) {
+                p[i] = (unsigned char)('0' + value % 10);
+                value /= 10;
+            }
+        } else if constexpr (Encoding == LENGTH_BINARY_BE) {
+            for (int i = LengthWidth - 1; i >= 0; i--, value >>= 8) p[i] = (unsigned char)value;
+        } else {
+            for (int i = 0; i < LengthWidth; i++, value >>= 8) p[i] = (unsigned char)value;
+        }
+    }
+
+    // 结束符，长度为 terminator_length
+    static inline const char* terminator() {
+        return "";
+    }
+
+    // 生成连接的电文头模板，默认全部置零
+    static inline void init_template(Head* head, const char* msgid, const char* senddc, const char* recvdc) {
+        (void)msgid; (void)senddc; (void)recvdc;
+        memset(head, 0, sizeof(Head));
+    }
+
+    // 组装电文时改写模板的拷贝，默认只填写长度字段；msgid 为 NULL 时保留模板中的电文号
+    static inline void stamp(Head* head, const char* msgid, int body_length, uint64_t seqno) {
+        (void)msgid; (void)seqno;
+        encode_length((char*)head, body_length + length_overhead);
+    }
+
+    // 在电文头中标记分片
+    static inline void stamp_fragment(Head* head, const FragmentInfo& frag) {
+        (void)head; (void)frag;
+    }
+
+    // 解析完整电文头中的分片标记，不是分片时返回 false
+    static inline bool parse_fragment(const char* head, FragmentInfo* frag) {
+        (void)head; (void)frag;
+        return false;
+    }
+};
+
+// 由格式描述生成的电文长度计算
+template <typename Traits>
+struct FrameCodec {
+    // 长度字段能描述的最大电文体
+    static constexpr long max_body_length = Traits::max_length_value - Traits::length_overhead;
+
+    // 由完整的电文头得到电文体长度，长度字段非法时返回 -1
+    static inline int body_length(const char* head) {
+        long value = Traits::decode_length(head);
+        if (value < Traits::length_overhead) return -1;
+        return (int)(value - Traits::length_overhead);
+    }
+
+    // 电文体为 body_length 字节时整条电文在线路上的字节数
+    static constexpr int frame_length(int body_length) {
+        return Traits::head_length + body_length + Traits::terminator_length;
+    }
+};
+
+// 本仓库的 40 字节字符电文头：四位十进制长度，包括电文头与 TerminatorLength 字节的结束符
+// 长度字段与 date、time、seqno 一起由 msghead_parse.h 一次校验，组装时填写电文号、日期时间与序列号
+template <int TerminatorLength>
+struct MsgHeadLayout : HeadLayout<MsgHead, HEAD_LENGTH_OFFSET, sizeof(MsgHead::length), LENGTH_DECIMAL,
+                                  MsgHead::includes_header(), MsgHead::includes_terminator(), TerminatorLength> {
+    typedef HeadLayout<MsgHead, HEAD_LENGTH_OFFSET, sizeof(MsgHead::length), LENGTH_DECIMAL,
+                       MsgHead::includes_header(), MsgHead::includes_terminator(), TerminatorLength> Base;
+
+    static inline long decode_length(const char* head) {
+        HeadFields fields;
+        return parse_head_fields(head, &fields) ? fields.length : -1;
+    }
+
+    static inline void init_template(MsgHead* head, const char* msgid, const char* senddc, const char* recvdc) {
+        head->init_template(msgid, senddc, recvdc);
+    }
+
+    static inline void stamp(MsgHead* head, const char* msgid, int body_length, uint64_t seqno) {
+        if (msgid != NULL) memcpy(head->msgid, msgid, sizeof(head->msgid));
+        head->fill_length(body_length + (Base::includes_terminator ? TerminatorLength : 0));
+        head->fill_datetime();
+        head->fill_seqno(seqno);
+    }
+
+    // 分片标记在 spare 字段中：'M'/'L'、4 位分片消息号、3 位分片序号
+    static constexpr bool supports_fragments = true;
+    static constexpr int max_fragments = 1000;
+    static constexpr int fragment_ids = 10000;
+
+    static inline void stamp_fragment(MsgHead* head, const FragmentInfo& frag) {
+        head->fill_fragment((unsigned)frag.id, (unsigned)frag.index, frag.last);
+    }
+
+    static inline bool parse_fragment(const char* head, FragmentInfo* frag) {
+        return ((const MsgHead*)head)->get_fragment(&frag->id, &frag->index, &frag->last);
+    }
+};
+
+// 默认格式：不带结束符
+typedef MsgHeadLayout<0> MsgHeadTraits;
+
+// 示例：电文体后带一个换行符作为结束符的 40 字节电文头，长度包括结束符
+struct MsgHeadLfTraits : MsgHeadLayout<1> {
+    static inline const char* terminator() {
+        return "\n";
+    }
+};
+
+// 分隔符模式没有电文头，head_type 只用于占位
+struct NoHead {
+    char unused;
+};
+
+// 分隔符模式：对端不发送长度，每条电文以 Delimiter 结束，电文体中不能含有 Delimiter
+// 接收方逐段扫描分隔符（见 byte_scan.h），去掉分隔符后交付；发送时在电文体后追加分隔符
+template <char Delimiter>
+struct DelimitedLayout {
+    typedef NoHead head_type;
+    static constexpr int head_length = 0;
+    static constexpr bool includes_header = false;
+    static constexpr bool includes_terminator = false;
+    static constexpr int terminator_length = 1;
+    static constexpr bool check_terminator = true;
+    static constexpr bool delimited = true;
+    static constexpr char delimiter = Delimiter;
+    // 没有长度字段，电文长度只受接收缓冲限制
+    static constexpr long max_length_value = LONG_MAX;
+    static constexpr int length_overhead = 0;
+
+    static inline long decode_length(const char* head) {
+        (void)head;
+        return -1;
+    }
+
+    static inline const char* terminator() {
+        static const char bytes[1] = {Delimiter};
+        return bytes;
+    }
+
+    static inline void init_template(NoHead* head, const char* msgid, const char* senddc, const char* recvdc) {
+        (void)msgid; (void)senddc; (void)recvdc;
+        head->unused = 0;
+    }
+
+    static inline void stamp(NoHead* head, const char* msgid, int body_length, uint64_t seqno) {
+        (void)head; (void)msgid; (void)body_length; (void)seqno;
+    }
+
+    // 没有电文头，不能标记分片
+    static constexpr bool supports_fragments = false;
+    static constexpr int max_fragments = 1;
+    static constexpr int fragment_ids = 1;
+
+    static inline void stamp_fragment(NoHead* head, const FragmentInfo& frag) {
+        (void)head; (void)frag;
+    }
+
+    static inline bool parse_fragment(const char* head, FragmentInfo* frag) {
+        (void)head; (void)frag;
+        return false;
+    }
+};
+
+// 示例：以换行符分隔的文本电文
+typedef DelimitedLayout<'\n'> LineDelimitedTraits;
+
+// 示例：8 字节二进制电文头，长度字段位于电文号之后、为大端整数且不包括电文头
+struct BinaryHead {
+    char msgid[4];              // 电文号
+    unsigned char length[2];    // 电文体长度，大端
+    unsigned char seqno[2];     // 序列号的低 16 位，大端
+};
+
+struct BinaryHeadTraits : HeadLayout<BinaryHead, offsetof(BinaryHead, length), sizeof(BinaryHead::length),
+                                     LENGTH_BINARY_BE, false, false> {
+    static inline void init_template(BinaryHead* head, const char* msgid, const char* senddc, const char* recvdc) {
+        (void)senddc; (void)recvdc;
+        memset(head, 0, sizeof(BinaryHead));
+        memcpy(head->msgid, msgid, sizeof(head->msgid));
+    }
+
+    static inline void stamp(BinaryHead* head, const char* msgid, int body_length, uint64_t seqno) {
+        if (msgid != NULL) memcpy(head->msgid, msgid, sizeof(head->msgid));
+        encode_length((char*)head, body_length + length_overhead);
+        head->seqno[0] = (unsigned char)(seqno >> 8);
+        head->seqno[1] = (unsigned char)seqno;
+    }
+};
+
+#endif // HEAD_TRAITS_H_
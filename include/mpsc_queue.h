@@ -0,0 +1,76 @@
+#ifndef MPSC_QUEUE_H_
+#define MPSC_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// ================ 有界无锁多生产者单消费者队列 =================
+// 基于 Dmitry Vyukov 的有界队列：每个槽带一个序号，生产者用一次 CAS 抢占写入位置，
+// 写完后发布槽的序号；消费者只有一个，按序号判断槽是否已发布，不需要 CAS。
+// 队列不负责唤醒，消费者的等待与唤醒由使用者另行实现。
+
+template <typename T, int Capacity>
+struct MpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "队列容量须为 2 的幂");
+
+    struct Cell {
+        std::atomic<size_t> seq;    // 等于写入位置时可写，等于写入位置 + 1 时已发布可读
+        T value;
+    };
+
+    Cell cells[Capacity];
+    alignas(64) std::atomic<size_t> enqueue_pos;    // 生产者共享的写入位置
+    alignas(64) size_t dequeue_pos;                 // 只由消费者访问的读取位置
+
+    void init() {
+        for (size_t i = 0; i < (size_t)Capacity; i++) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos.store(0, std::memory_order_relaxed);
+        dequeue_pos = 0;
+    }
+
+    // 入队，可由任意线程调用；队列满时返回 false
+    bool try_push(const T& value) {
+        Cell* cell;
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & (Capacity - 1)];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;   // 槽仍未被消费者取走，队列已满
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 出队，只能由消费者线程调用；队列空或下一个槽尚未发布时返回 false
+    bool try_pop(T* out) {
+        Cell* cell = &cells[dequeue_pos & (Capacity - 1)];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        if (seq != dequeue_pos + 1) return false;
+        *out = cell->value;
+        cell->seq.store(dequeue_pos + Capacity, std::memory_order_release);
+        dequeue_pos++;
+        return true;
+    }
+
+    // 批量出队至多 max 个元素，返回实际取出的个数
+    int pop_batch(T* out, int max) {
+        int n = 0;
+        while (n < max && try_pop(&out[n])) {
+            n++;
+        }
+        return n;
+    }
+};
+
+#endif // MPSC_QUEUE_H_
@@ -3,7 +3,10 @@
 
 #include <stdint.h>
 #include <arpa/inet.h> // For ntohs
-#include <time.h>      // For time() and strftime()
+#include <time.h>      // For clock_gettime() and localtime_r()
+#include <stddef.h>    // For offsetof
+#include "datetime_cache.h" // 缓存的日期时间与定长数字格式化
+#include "msghead_parse.h"  // 数字字段的向量化校验与解码
 
 // 电文头的定义
 struct MsgHead
@@ -23,7 +26,8 @@ struct MsgHead
     char recvdc[2];
     // 7 序列号     该字段用于区分在相同时间段内传输的不同电文，应用可以通过该字段加上时间日期来唯一确定某条电文。该字段为十进制字符，可以不连续 C6
     char seqno[6];
-    // 8 保留域     该字段为保留字段，暂未使用，置空 C8
+    // 8 保留域     不分片的电文置空；超过一条电文的大消息拆分为多个分片，每片在此标记：
+    //              1 位 'M'（后面还有分片）或 'L'（最后一片）、4 位分片消息号、3 位分片序号（从 000 开始） C8
     char spare[8];
     
 
@@ -34,6 +38,11 @@ struct MsgHead
     {
         return string_to_int(length) - get_head_length();
     }
+    // 校验 length、date、time、seqno 字段均为十进制数字并解码到 out，有非数字字符时返回 false
+    bool parse_fields(HeadFields* out) const
+    {
+        return parse_head_fields(length, out);
+    }
     // 获取电文头的大小
     static constexpr int get_head_length()
     {
@@ -42,21 +51,10 @@ struct MsgHead
     // 随机填充符合条件的电文头，用于测试，参数为电文体长度
     void random_fill(int body_length)
     {
-        char temp_string[16];
-        // 填充 length 字段
-        int total_length = get_head_length() + body_length;
-        total_length = total_length > 9999 ? 9999 : total_length;  // 限制最大值为 9999
-        snprintf(temp_string, sizeof(temp_string), "%04d", total_length);
-        memcpy(length, temp_string, sizeof(length));
+        fill_length(body_length);
         // 填充 msgid 字段
         memcpy(msgid, "TEST", sizeof(msgid));
-        // 使用当前系统时间填充 date 和 time 字段
-        time_t now = ::time(nullptr);
-        struct tm* tstruct = localtime(&now);
-        strftime(temp_string, sizeof(date) + 1, "%Y%m%d", tstruct);
-        memcpy(date, temp_string, sizeof(date));
-        strftime(temp_string, sizeof(time) + 1, "%H%M%S", tstruct);
-        memcpy(time, temp_string, sizeof(time));
+        fill_datetime();
         // 填充 senddc 字段
         memcpy(senddc, "L3", sizeof(senddc));
         // 填充 recvdc 字段
@@ -66,6 +64,59 @@ struct MsgHead
         // 填充 spare 字段
         memcpy(spare, "        ", sizeof(spare));
     }
+    // 填充电文头模板：预置电文号、发送端与接收端 DC，其余字段置为占位值，发送时再改写长度、日期时间与序列号
+    void init_template(const char* id, const char* send_dc, const char* recv_dc)
+    {
+        memcpy(length, "0000", sizeof(length));
+        memcpy(msgid, id, sizeof(msgid));
+        memcpy(date, "00000000", sizeof(date));
+        memcpy(time, "000000", sizeof(time));
+        memcpy(senddc, send_dc, sizeof(senddc));
+        memcpy(recvdc, recv_dc, sizeof(recvdc));
+        memcpy(seqno, "000000", sizeof(seqno));
+        memcpy(spare, "        ", sizeof(spare));
+    }
+    // 以序列号对 1000000 取模后的六位数字填充 seqno 字段
+    void fill_seqno(uint64_t seq)
+    {
+        write_6digits(seqno, (unsigned)(seq % 1000000));
+    }
+    // 在 spare 字段标记分片：id 为 0 ~ 9999 的分片消息号，index 为 0 ~ 999 的分片序号，last 表示最后一片
+    void fill_fragment(unsigned id, unsigned index, bool last)
+    {
+        spare[0] = last ? 'L' : 'M';
+        write_4digits(spare + 1, id);
+        spare[5] = (char)('0' + index / 100);
+        write_2digits(spare + 6, index % 100);
+    }
+    // 解析 spare 字段中的分片标记，不是分片（或标记格式不符）时返回 false
+    bool get_fragment(int* id, int* index, bool* last) const
+    {
+        if (spare[0] != 'M' && spare[0] != 'L') return false;
+        int value[7];
+        for (int i = 0; i < 7; i++) {
+            value[i] = spare[i + 1] - '0';
+            if (value[i] < 0 || value[i] > 9) return false;
+        }
+        *id = ((value[0] * 10 + value[1]) * 10 + value[2]) * 10 + value[3];
+        *index = (value[4] * 10 + value[5]) * 10 + value[6];
+        *last = spare[0] == 'L';
+        return true;
+    }
+    // 按电文体长度填充 length 字段，超过 9999 时限制为 9999
+    void fill_length(int body_length)
+    {
+        int total_length = get_head_length() + body_length;
+        total_length = total_length > 9999 ? 9999 : total_length;
+        write_4digits(length, (unsigned)total_length);
+    }
+    // 使用当前系统时间填充 date 和 time 字段，日期时间每秒只格式化一次
+    void fill_datetime()
+    {
+        const DateTimeCache& now = datetime_now();
+        memcpy(date, now.digits, sizeof(date));
+        memcpy(time, now.digits + sizeof(date), sizeof(time));
+    }
     // 指示字段 length 是否包括电文头
     static constexpr bool includes_header() {
         return true;
@@ -89,4 +140,10 @@ struct MsgHead
     }
 };
 
+static_assert(offsetof(MsgHead, length) == HEAD_LENGTH_OFFSET &&
+              offsetof(MsgHead, date) == HEAD_DATE_OFFSET &&
+              offsetof(MsgHead, time) == HEAD_TIME_OFFSET &&
+              offsetof(MsgHead, seqno) == HEAD_SEQNO_OFFSET &&
+              sizeof(MsgHead) >= HEAD_PARSE_BYTES, "msghead_parse.h 中的字段偏移须与 MsgHead 一致");
+
 #endif // MSGHEAD_H_
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef MSGHEAD_PARSE_H_
+#define MSGHEAD_PARSE_H_
+
+#include <stdint.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HEAD_PARSE_X86 1
+#endif
+
+// ================ 电文头数字字段的向量化校验与解码 =================
+// 电文头前 32 字节中 length、date、time、seqno 四个字段须全部为 '0' ~ '9'，
+// 一次载入这 32 字节，逐字节减去 '0' 后判断是否不超过 9，得到一个 32 位掩码与期望的数字位掩码比较；
+// 同一批寄存器接着两两合并为 0 ~ 99、再合并为 0 ~ 9999 的分组，四个字段由分组拼出，不逐字符循环。
+// SSE2 为基线实现，运行时检测到 AVX2 时改用一条 256 位指令序列；非 x86 平台使用逐字符的实现。
+
+// 电文头中数字字段的偏移与长度，与 MsgHead 的布局一致（由 msghead.h 中的 static_assert 保证）
+#define HEAD_LENGTH_OFFSET 0
+#define HEAD_DATE_OFFSET 8
+#define HEAD_TIME_OFFSET 16
+#define HEAD_SEQNO_OFFSET 26
+#define HEAD_PARSE_BYTES 32     // 参与校验的电文头前缀长度，数字字段都在其中
+
+// 前 32 字节中须为数字的字节：length[0,4)、date[8,16)、time[16,22)、seqno[26,32)
+static const uint32_t HEAD_DIGIT_MASK = 0x0000000Fu | 0x003FFF00u | 0xFC000000u;
+
+// 解码后的电文头数字字段
+struct HeadFields {
+    int length;     // 电文总长度
+    int date;       // YYYYMMDD
+    int time;       // HHMMSS
+    int seqno;      // 序列号
+};
+
+typedef bool (*HeadParseFn)(const char* head, HeadFields* out);
+
+// 由两两合并（16 位分组 0 ~ 99）与四四合并（32 位分组 0 ~ 9999）的结果拼出各字段
+// pairs[k] 为第 2k、2k+1 字节组成的两位数，quads[k] 为第 4k ~ 4k+3 字节组成的四位数
+static inline void head_fields_from_groups(const uint16_t* pairs, const uint32_t* quads, HeadFields* out) {
+    out->length = (int)quads[0];
+    out->date = (int)(quads[2] * 10000 + quads[3]);
+    out->time = (int)(quads[4] * 100 + pairs[10]);
+    out->seqno = (int)(pairs[13] * 10000 + quads[7]);
+}
+
+// 逐字符的实现，用于非 x86 平台，也作为向量实现的对照
+static inline bool parse_head_scalar(const char* head, HeadFields* out) {
+    uint8_t d[HEAD_PARSE_BYTES];
+    for (int i = 0; i < HEAD_PARSE_BYTES; i++) {
+        d[i] = (uint8_t)(head[i] - '0');
+        if ((HEAD_DIGIT_MASK >> i & 1) && d[i] > 9) return false;
+    }
+    uint16_t pairs[HEAD_PARSE_BYTES / 2];
+    uint32_t quads[HEAD_PARSE_BYTES / 4];
+    for (int k = 0; k < HEAD_PARSE_BYTES / 2; k++) {
+        pairs[k] = (uint16_t)(d[2 * k] * 10 + d[2 * k + 1]);
+    }
+    for (int k = 0; k < HEAD_PARSE_BYTES / 4; k++) {
+        quads[k] = pairs[2 * k] * 100u + pairs[2 * k + 1];
+    }
+    head_fields_from_groups(pairs, quads, out);
+    return true;
+}
+
+#ifdef HEAD_PARSE_X86
+// 16 字节的数字判断与两两、四四合并；非数字字节的合并结果无意义，由掩码排除
+static inline uint32_t head_digits_sse2(__m128i x, __m128i* pairs, __m128i* quads) {
+    __m128i d = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+    // 无符号比较 d <= 9：min(d, 9) == d
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d));
+    // 小端下每个 16 位分组的低字节是高位数字
+    __m128i hi = _mm_and_si128(d, _mm_set1_epi16(0x00FF));
+    __m128i lo = _mm_srli_epi16(d, 8);
+    *pairs = _mm_add_epi16(_mm_mullo_epi16(hi, _mm_set1_epi16(10)), lo);
+    *quads = _mm_madd_epi16(*pairs, _mm_set1_epi32(0x00010064));   // 每对 16 位分组 ×(100, 1) 相加
+    return mask;
+}
+
+static inline bool parse_head_sse2(const char* head, HeadFields* out) {
+    __m128i p0, p1, q0, q1;
+    uint32_t mask = head_digits_sse2(_mm_loadu_si128((const __m128i*)head), &p0, &q0);
+    mask |= head_digits_sse2(_mm_loadu_si128((const __m128i*)(head + 16)), &p1, &q1) << 16;
+    if ((mask & HEAD_DIGIT_MASK) != HEAD_DIGIT_MASK) return false;
+    uint16_t pairs[HEAD_PARSE_BYTES / 2];
+    uint32_t quads[HEAD_PARSE_BYTES / 4];
+    _mm_storeu_si128((__m128i*)pairs, p0);
+    _mm_storeu_si128((__m128i*)(pairs + 8), p1);
+    _mm_storeu_si128((__m128i*)quads, q0);
+    _mm_storeu_si128((__m128i*)(quads + 4), q1);
+    head_fields_from_groups(pairs, quads, out);
+    return true;
+}
+
+__attribute__((target("avx2")))
+static inline bool parse_head_avx2(const char* head, HeadFields* out) {
+    __m256i d = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)head), _mm256_set1_epi8('0'));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d));
+    if ((mask & HEAD_DIGIT_MASK) != HEAD_DIGIT_MASK) return false;
+    // 字节已确认为 0 ~ 9，maddubs 直接按 (10, 1) 两两合并
+    __m256i p = _mm256_maddubs_epi16(d, _mm256_set1_epi16(0x010A));
+    __m256i q = _mm256_madd_epi16(p, _mm256_set1_epi32(0x00010064));
+    uint16_t pairs[HEAD_PARSE_BYTES / 2];
+    uint32_t quads[HEAD_PARSE_BYTES / 4];
+    _mm256_storeu_si256((__m256i*)pairs, p);
+    _mm256_storeu_si256((__m256i*)quads, q);
+    head_fields_from_groups(pairs, quads, out);
+    return true;
+}
+#endif
+
+// 按 CPU 支持的指令集选择实现，进程内只检测一次
+static inline HeadParseFn select_head_parser() {
+#ifdef HEAD_PARSE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return parse_head_avx2;
+    return parse_head_sse2;
+#else
+    return parse_head_scalar;
+#endif
+}
+
+// 校验 head 起始的电文头（至少 HEAD_PARSE_BYTES 字节）的数字字段并解码到 out，有非数字字符时返回 false
+static inline bool parse_head_fields(const char* head, HeadFields* out) {
+    static const HeadParseFn parser = select_head_parser();
+    return parser(head, out);
+}
+
+#endif // MSGHEAD_PARSE_H_
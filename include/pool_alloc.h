@@ -0,0 +1,274 @@
+#ifndef POOL_ALLOC_H_
+#define POOL_ALLOC_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <atomic>
+
+// ================ 分级内存池 =================
+// 为发送路径上频繁分配、且常在另一个线程释放的小对象（缓冲链节点、1~9999 字节的电文体）提供内存。
+// - 按大小分为 64、128、...、8192、10240 字节共 9 级，更大的请求直接使用 malloc
+// - 每个线程每级有一个空闲块缓存，分配与释放在缓存内完成，不加锁
+// - 缓存空时从该级的全局仓库批量取 POOL_BATCH 块，仓库也空时向系统申请一整块 slab 切分；
+//   缓存超过 POOL_CACHE_MAX 块时批量归还 POOL_BATCH 块到仓库。
+//   因此在一个线程分配、另一个线程释放的块经仓库流回分配线程，不会在释放线程无限堆积
+// - 从系统申请的内存只在仓库中循环使用，不归还给系统
+// 每块前有 POOL_HEADER 字节的块头记录大小级别，pool_free 据此找到所属的级别。
+
+#define POOL_CLASS_COUNT 9
+#define POOL_MAX_BLOCK 10240            // 最大一级的块大小，覆盖 9999 字节的电文
+#define POOL_BATCH 32                   // 线程缓存与全局仓库之间一次转移的块数
+#define POOL_CACHE_MAX 64               // 每个线程每级最多缓存的空闲块数
+#define POOL_SLAB_BYTES (256 * 1024)    // 一次向系统申请的内存大小
+#define POOL_HEADER 16                  // 块头大小，保持返回地址 16 字节对齐
+#define POOL_LARGE_CLASS 0xFF           // 块头中表示直接由 malloc 分配的级别
+
+// 空闲块，链接指针存放在块头中级别字节之后
+struct PoolFreeBlock {
+    uint8_t size_class;
+    PoolFreeBlock* next;
+};
+static_assert(sizeof(PoolFreeBlock) <= POOL_HEADER, "空闲块链接须放在块头内");
+
+// 一个大小级别的统计
+struct PoolClassStats {
+    size_t block_size;
+    uint64_t allocs;            // 分配次数
+    uint64_t frees;             // 释放次数
+    uint64_t reserved_blocks;   // 向系统申请的块数
+    uint64_t depot_blocks;      // 当前在全局仓库中的空闲块数
+    uint64_t depot_transfers;   // 线程缓存与仓库之间的批量转移次数
+};
+
+// 块大小对应的级别，超过最大一级返回 -1
+static inline int pool_size_class(size_t size) {
+    if (size <= 64) return 0;
+    if (size > POOL_MAX_BLOCK) return -1;
+    int c = 64 - __builtin_clzll((unsigned long long)(size - 1)) - 6;
+    return c < POOL_CLASS_COUNT ? c : POOL_CLASS_COUNT - 1;
+}
+
+static inline size_t pool_class_size(int c) {
+    return c == POOL_CLASS_COUNT - 1 ? POOL_MAX_BLOCK : (size_t)64 << c;
+}
+
+struct PoolThreadCache;
+
+// 全局仓库，每级一把锁，只在线程缓存空或满时访问
+struct PoolGlobal {
+    pthread_mutex_t class_mutex[POOL_CLASS_COUNT];
+    PoolFreeBlock* depot[POOL_CLASS_COUNT];
+    uint64_t depot_count[POOL_CLASS_COUNT];
+    uint64_t reserved_blocks[POOL_CLASS_COUNT];
+    uint64_t depot_transfers[POOL_CLASS_COUNT];
+
+    // 线程缓存登记表，用于汇总统计
+    pthread_mutex_t registry_mutex;
+    PoolThreadCache* caches;
+    uint64_t retired_allocs[POOL_CLASS_COUNT];  // 已退出线程的计数
+    uint64_t retired_frees[POOL_CLASS_COUNT];
+    std::atomic<uint64_t> large_allocs;
+    std::atomic<uint64_t> large_frees;
+
+    PoolGlobal() : caches(NULL), large_allocs(0), large_frees(0) {
+        for (int c = 0; c < POOL_CLASS_COUNT; c++) {
+            pthread_mutex_init(&class_mutex[c], NULL);
+            depot[c] = NULL;
+            depot_count[c] = 0;
+            reserved_blocks[c] = 0;
+            depot_transfers[c] = 0;
+            retired_allocs[c] = 0;
+            retired_frees[c] = 0;
+        }
+        pthread_mutex_init(&registry_mutex, NULL);
+    }
+};
+
+static inline PoolGlobal& pool_global() {
+    static PoolGlobal global;
+    return global;
+}
+
+// 把 head 开头的 count 块放回仓库
+static inline void pool_depot_put(int c, PoolFreeBlock* head, PoolFreeBlock* tail, int count) {
+    PoolGlobal& g = pool_global();
+    pthread_mutex_lock(&g.class_mutex[c]);
+    tail->next = g.depot[c];
+    g.depot[c] = head;
+    g.depot_count[c] += count;
+    g.depot_transfers[c]++;
+    pthread_mutex_unlock(&g.class_mutex[c]);
+}
+
+// 从仓库取至多 POOL_BATCH 块，仓库空时先申请一个 slab 切分入库；返回链表头，*count 为块数
+static inline PoolFreeBlock* pool_depot_take(int c, int* count) {
+    PoolGlobal& g = pool_global();
+    pthread_mutex_lock(&g.class_mutex[c]);
+    if (g.depot[c] == NULL) {
+        size_t stride = POOL_HEADER + pool_class_size(c);
+        size_t blocks = POOL_SLAB_BYTES / stride;
+        if (blocks < POOL_BATCH) blocks = POOL_BATCH;
+        char* slab = (char*)malloc(blocks * stride);
+        if (slab == NULL) {
+            pthread_mutex_unlock(&g.class_mutex[c]);
+            *count = 0;
+            return NULL;
+        }
+        for (size_t i = 0; i < blocks; i++) {
+            PoolFreeBlock* b = (PoolFreeBlock*)(slab + i * stride);
+            b->size_class = (uint8_t)c;
+            b->next = g.depot[c];
+            g.depot[c] = b;
+        }
+        g.depot_count[c] += blocks;
+        g.reserved_blocks[c] += blocks;
+    }
+    PoolFreeBlock* head = g.depot[c];
+    PoolFreeBlock* tail = head;
+    int n = 1;
+    while (n < POOL_BATCH && tail->next != NULL) {
+        tail = tail->next;
+        n++;
+    }
+    g.depot[c] = tail->next;
+    tail->next = NULL;
+    g.depot_count[c] -= n;
+    g.depot_transfers[c]++;
+    pthread_mutex_unlock(&g.class_mutex[c]);
+    *count = n;
+    return head;
+}
+
+// 每个线程的空闲块缓存，线程退出时全部归还仓库
+struct PoolThreadCache {
+    PoolFreeBlock* head[POOL_CLASS_COUNT];
+    int count[POOL_CLASS_COUNT];
+    // 只由所属线程写入，统计时由其他线程读取
+    std::atomic<uint64_t> allocs[POOL_CLASS_COUNT];
+    std::atomic<uint64_t> frees[POOL_CLASS_COUNT];
+    PoolThreadCache* prev;
+    PoolThreadCache* next;
+
+    PoolThreadCache() {
+        for (int c = 0; c < POOL_CLASS_COUNT; c++) {
+            head[c] = NULL;
+            count[c] = 0;
+            allocs[c].store(0, std::memory_order_relaxed);
+            frees[c].store(0, std::memory_order_relaxed);
+        }
+        PoolGlobal& g = pool_global();
+        pthread_mutex_lock(&g.registry_mutex);
+        prev = NULL;
+        next = g.caches;
+        if (next != NULL) next->prev = this;
+        g.caches = this;
+        pthread_mutex_unlock(&g.registry_mutex);
+    }
+
+    ~PoolThreadCache() {
+        PoolGlobal& g = pool_global();
+        for (int c = 0; c < POOL_CLASS_COUNT; c++) {
+            if (head[c] != NULL) {
+                PoolFreeBlock* tail = head[c];
+                while (tail->next != NULL) tail = tail->next;
+                pool_depot_put(c, head[c], tail, count[c]);
+            }
+        }
+        pthread_mutex_lock(&g.registry_mutex);
+        for (int c = 0; c < POOL_CLASS_COUNT; c++) {
+            g.retired_allocs[c] += allocs[c].load(std::memory_order_relaxed);
+            g.retired_frees[c] += frees[c].load(std::memory_order_relaxed);
+        }
+        if (prev != NULL) prev->next = next;
+        else g.caches = next;
+        if (next != NULL) next->prev = prev;
+        pthread_mutex_unlock(&g.registry_mutex);
+    }
+};
+
+static inline PoolThreadCache& pool_thread_cache() {
+    thread_local PoolThreadCache cache;
+    return cache;
+}
+
+// 只由所属线程递增的计数，不需要原子的读改写
+static inline void pool_count(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// 分配 size 字节，失败返回 NULL
+static inline void* pool_alloc(size_t size) {
+    int c = pool_size_class(size);
+    if (c < 0) {
+        char* base = (char*)malloc(POOL_HEADER + size);
+        if (base == NULL) return NULL;
+        base[0] = (char)POOL_LARGE_CLASS;
+        pool_global().large_allocs.fetch_add(1, std::memory_order_relaxed);
+        return base + POOL_HEADER;
+    }
+    PoolThreadCache& tc = pool_thread_cache();
+    if (tc.head[c] == NULL) {
+        tc.head[c] = pool_depot_take(c, &tc.count[c]);
+        if (tc.head[c] == NULL) return NULL;
+    }
+    PoolFreeBlock* b = tc.head[c];
+    tc.head[c] = b->next;
+    tc.count[c]--;
+    pool_count(tc.allocs[c]);
+    return (char*)b + POOL_HEADER;
+}
+
+// 释放 pool_alloc 分配的内存，可在任意线程调用
+static inline void pool_free(void* p) {
+    if (p == NULL) return;
+    PoolFreeBlock* b = (PoolFreeBlock*)((char*)p - POOL_HEADER);
+    if (b->size_class == POOL_LARGE_CLASS) {
+        pool_global().large_frees.fetch_add(1, std::memory_order_relaxed);
+        free(b);
+        return;
+    }
+    int c = b->size_class;
+    PoolThreadCache& tc = pool_thread_cache();
+    b->next = tc.head[c];
+    tc.head[c] = b;
+    tc.count[c]++;
+    pool_count(tc.frees[c]);
+    // 缓存过多时把最近释放的一批块归还仓库
+    if (tc.count[c] > POOL_CACHE_MAX) {
+        PoolFreeBlock* head = tc.head[c];
+        PoolFreeBlock* tail = head;
+        for (int i = 1; i < POOL_BATCH; i++) tail = tail->next;
+        tc.head[c] = tail->next;
+        tc.count[c] -= POOL_BATCH;
+        pool_depot_put(c, head, tail, POOL_BATCH);
+    }
+}
+
+// 汇总各级统计写入 stats[POOL_CLASS_COUNT]，直接 malloc 的大块次数写入 *large_allocs、*large_frees
+static inline void pool_get_stats(PoolClassStats* stats, uint64_t* large_allocs, uint64_t* large_frees) {
+    PoolGlobal& g = pool_global();
+    pthread_mutex_lock(&g.registry_mutex);
+    for (int c = 0; c < POOL_CLASS_COUNT; c++) {
+        stats[c].block_size = pool_class_size(c);
+        stats[c].allocs = g.retired_allocs[c];
+        stats[c].frees = g.retired_frees[c];
+        for (PoolThreadCache* tc = g.caches; tc != NULL; tc = tc->next) {
+            stats[c].allocs += tc->allocs[c].load(std::memory_order_relaxed);
+            stats[c].frees += tc->frees[c].load(std::memory_order_relaxed);
+        }
+    }
+    pthread_mutex_unlock(&g.registry_mutex);
+    for (int c = 0; c < POOL_CLASS_COUNT; c++) {
+        pthread_mutex_lock(&g.class_mutex[c]);
+        stats[c].reserved_blocks = g.reserved_blocks[c];
+        stats[c].depot_blocks = g.depot_count[c];
+        stats[c].depot_transfers = g.depot_transfers[c];
+        pthread_mutex_unlock(&g.class_mutex[c]);
+    }
+    *large_allocs = g.large_allocs.load(std::memory_order_relaxed);
+    *large_frees = g.large_frees.load(std::memory_order_relaxed);
+}
+
+#endif // POOL_ALLOC_H_
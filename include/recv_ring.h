@@ -0,0 +1,65 @@
+#ifndef RECV_RING_H_
+#define RECV_RING_H_
+
+#include <string.h>
+
+// 每个连接的接收缓冲
+//
+// 一次 recv() 尽可能填满 [tail, Capacity) 的空闲区域，随后在缓冲内原地解析出所有完整电文，
+// 解析完成的数据通过前移 head 释放，不做任何拷贝或清零。
+// 为了让每条电文在缓冲内保持连续、可原地解析，回绕时不把电文拆成两段，
+// 而是在尾部空闲不足时把尚未解析的残余字节（不足一条电文）搬到缓冲起始处。
+//
+//   data: [ 已解析 | 未解析 (head..tail) | 空闲 (tail..Capacity) ]
+template <int Capacity>
+struct RecvRing {
+    char data[Capacity];
+    int head;   // 第一个未解析字节的偏移
+    int tail;   // 已写入数据的结束偏移
+    int scanned;    // 分隔符模式下，未解析数据开头已确认不含分隔符的字节数，续收半条电文时不重复扫描
+
+    // 丢弃全部数据，只重置读写偏移，不触碰数据区，开销为 O(1)
+    void reset() {
+        head = 0;
+        tail = 0;
+        scanned = 0;
+    }
+    // 未解析的字节数
+    int readable() const {
+        return tail - head;
+    }
+    // 未解析数据的起始地址
+    const char* read_ptr() const {
+        return data + head;
+    }
+    // 标记前 n 个未解析字节已消费，缓冲读空时回到起始处
+    void consume(int n) {
+        head += n;
+        if (head == tail) {
+            head = 0;
+            tail = 0;
+        }
+    }
+    // 尾部可写入的字节数
+    int writable() const {
+        return Capacity - tail;
+    }
+    // 下一次写入的起始地址
+    char* write_ptr() {
+        return data + tail;
+    }
+    // 提交写入的 n 个字节
+    void commit(int n) {
+        tail += n;
+    }
+    // 保证尾部至少有 min_free 字节空闲，不足时把未解析数据搬到缓冲起始处
+    void reserve(int min_free) {
+        if (writable() >= min_free || head == 0) return;
+        int n = readable();
+        memmove(data, data + head, n);
+        head = 0;
+        tail = n;
+    }
+};
+
+#endif // RECV_RING_H_
@@ -0,0 +1,42 @@
+#ifndef SEND_CHAIN_H_
+#define SEND_CHAIN_H_
+
+#include <stddef.h>
+
+// ================ 发送缓冲链 =================
+// 每个连接待写入套接字的电文按入队顺序挂成单链表，反应器从链头聚合发送，生产者经尾指针追加。
+// 节点布局与追加操作放在这里，socket_comm.cpp 与 test/bench_send.cpp 使用同一份实现。
+
+// 电文体的释放函数，电文发送完毕或被丢弃时以电文体地址和 release_ctx 调用
+typedef void (*BodyRelease)(char* data, void* ctx);
+
+// 发送缓冲链节点，Head 为线路上电文头的类型（见 head_traits.h 中的 head_type）
+// 电文头内联在节点中，电文体仍指向消息移交过来的数据，发送时作为两段 iovec，不拼接拷贝
+// 已成帧的电文不使用内联电文头，整条电文作为电文体发送
+template <typename Head>
+struct SendBufferNode {
+    Head head;              // 电文头
+    int head_length;        // 内联电文头的长度，已成帧的电文为 0
+    char* body;             // 电文体
+    int body_length;
+    int tail_length;        // 电文体之后追加的结束符长度，已成帧的电文为 0
+    int total_length;       // 电文头、电文体与结束符的总长度
+    int sent_bytes;         // 已发送的字节数，从电文头开始计算
+    BodyRelease release;    // 电文体的释放函数
+    void* release_ctx;
+    SendBufferNode* next;
+};
+
+// 经尾指针把 node 加到以 *head 开始、*tail 结束的缓冲链末尾，积压再多也不需要遍历
+// 链为空时 *head 为 NULL，*tail 的值被忽略；node->next 须已置为 NULL
+template <typename Node>
+static inline void append_send_buffer(Node** head, Node** tail, Node* node) {
+    if (*head == NULL) {
+        *head = node;
+    } else {
+        (*tail)->next = node;
+    }
+    *tail = node;
+}
+
+#endif // SEND_CHAIN_H_
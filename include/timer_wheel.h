@@ -0,0 +1,112 @@
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ================ 哈希时间轮 =================
+// 每个 tick 为 1 毫秒，定时器按到期 tick 对槽数取模挂到对应槽的双向链表上，
+// 超过一圈的定时器留在槽中，直到到期的那一圈才触发。
+// 插入、取消为 O(1)；推进时只访问经过的槽，空闲很久后推进最多访问一圈。
+// 一个 TimerWheel 实例只能由一个线程使用。
+
+// 定时器节点，嵌入到使用者的数据中；同一节点同一时刻只能挂在一个槽上
+struct TimerNode {
+    TimerNode* prev;    // 未挂到时间轮上时为 NULL
+    TimerNode* next;
+    uint64_t expires;   // 到期时刻（毫秒）
+    int id;             // 使用者自定义的标识
+
+    bool pending() const {
+        return prev != NULL;
+    }
+};
+
+template <int Slots>
+struct TimerWheel {
+    static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0, "时间轮槽数须为 2 的幂");
+
+    TimerNode slots[Slots];     // 每个槽的哨兵节点
+    uint64_t now_tick;          // 已推进到的时刻（毫秒），之前到期的定时器都已触发
+    int count;                  // 挂在时间轮上的定时器数
+
+    void init(uint64_t now_ms) {
+        for (int i = 0; i < Slots; i++) {
+            slots[i].prev = &slots[i];
+            slots[i].next = &slots[i];
+        }
+        now_tick = now_ms;
+        count = 0;
+    }
+
+    // 设置定时器在 expires_ms 到期，已挂在时间轮上的定时器会被重新设置
+    void schedule(TimerNode* node, uint64_t expires_ms) {
+        if (node->pending()) cancel(node);
+        // 已经过去的时刻在下一次推进时触发
+        if (expires_ms <= now_tick) expires_ms = now_tick + 1;
+        node->expires = expires_ms;
+        TimerNode* head = &slots[expires_ms & (Slots - 1)];
+        node->prev = head->prev;
+        node->next = head;
+        head->prev->next = node;
+        head->prev = node;
+        count++;
+    }
+
+    void cancel(TimerNode* node) {
+        if (!node->pending()) return;
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->prev = NULL;
+        node->next = NULL;
+        count--;
+    }
+
+    // 推进到 now_ms，对每个到期的定时器调用 fn(TimerNode*)
+    // 先摘下全部到期的定时器再逐个回调，回调中可以重新设置定时器
+    template <typename Fn>
+    void advance(uint64_t now_ms, Fn fn) {
+        if (now_ms <= now_tick) return;
+        TimerNode* expired = NULL;
+        if (count > 0) {
+            uint64_t ticks = now_ms - now_tick;
+            if (ticks > (uint64_t)Slots) ticks = Slots;
+            for (uint64_t t = 1; t <= ticks; t++) {
+                TimerNode* head = &slots[(now_tick + t) & (Slots - 1)];
+                TimerNode* node = head->next;
+                while (node != head) {
+                    TimerNode* next = node->next;
+                    if (node->expires <= now_ms) {
+                        cancel(node);
+                        node->next = expired;
+                        expired = node;
+                    }
+                    node = next;
+                }
+            }
+        }
+        now_tick = now_ms;
+        while (expired != NULL) {
+            TimerNode* node = expired;
+            expired = node->next;
+            node->next = NULL;
+            fn(node);
+        }
+    }
+
+    // 距离最近一个非空槽的毫秒数，不超过 max_ms，用作事件循环的等待超时
+    // 槽中的定时器可能属于之后的圈数，此时只是提前醒来一次
+    int next_timeout(uint64_t now_ms, int max_ms) const {
+        if (count == 0) return max_ms;
+        uint64_t limit = now_tick + (max_ms < Slots ? max_ms : Slots);
+        for (uint64_t t = now_tick + 1; t <= limit; t++) {
+            const TimerNode* head = &slots[t & (Slots - 1)];
+            if (head->next != head) {
+                return t > now_ms ? (int)(t - now_ms) : 0;
+            }
+        }
+        return limit > now_ms ? (int)(limit - now_ms) : 0;
+    }
+};
+
+#endif // TIMER_WHEEL_H_
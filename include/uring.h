@@ -0,0 +1,234 @@
+#ifndef URING_H_
+#define URING_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// ================ io_uring 的最小封装 =================
+// 直接使用系统调用，不依赖 liburing。
+// 需要的内核特性：IORING_FEAT_SINGLE_MMAP、IORING_FEAT_EXT_ARG（5.11）、
+// 提供缓冲环 IORING_REGISTER_PBUF_RING 与多发 accept（5.19）、多发 recv（6.0）。
+// 一个 Uring 实例只能由一个线程提交和收割。
+
+static inline int sys_io_uring_setup(unsigned entries, struct io_uring_params* p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static inline int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                                     unsigned flags, const void* arg, size_t argsz) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz);
+}
+
+static inline int sys_io_uring_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+struct Uring {
+    int fd;
+    // 提交队列
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    struct io_uring_sqe* sqes;
+    unsigned sqe_tail;      // 本地已填写的 SQE 尾部
+    unsigned sqe_submitted; // 已经交给内核的 SQE 尾部
+    // 完成队列
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+    // 映射的内存
+    void* ring_ptr;
+    size_t ring_len;
+    size_t sqes_len;
+
+    // 创建 io_uring 实例，失败返回负的 errno
+    int init(unsigned entries) {
+        struct io_uring_params p;
+        memset(&p, 0, sizeof(p));
+        p.flags = IORING_SETUP_CQSIZE;
+        p.cq_entries = entries * 4;   // 多发请求会产生大量完成事件，完成队列留足余量
+        fd = sys_io_uring_setup(entries, &p);
+        if (fd < 0) return -errno;
+        if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !(p.features & IORING_FEAT_EXT_ARG)) {
+            close(fd);
+            fd = -1;
+            return -ENOSYS;
+        }
+
+        size_t sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        size_t cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+        ring_len = sq_len > cq_len ? sq_len : cq_len;
+        ring_ptr = mmap(NULL, ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd, IORING_OFF_SQ_RING);
+        if (ring_ptr == MAP_FAILED) {
+            int err = -errno;
+            close(fd);
+            fd = -1;
+            return err;
+        }
+        sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+        sqes = (struct io_uring_sqe*)mmap(NULL, sqes_len, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            int err = -errno;
+            munmap(ring_ptr, ring_len);
+            close(fd);
+            fd = -1;
+            return err;
+        }
+
+        char* base = (char*)ring_ptr;
+        sq_head = (unsigned*)(base + p.sq_off.head);
+        sq_tail = (unsigned*)(base + p.sq_off.tail);
+        sq_mask = *(unsigned*)(base + p.sq_off.ring_mask);
+        sq_entries = p.sq_entries;
+        // SQ 下标数组固定为恒等映射，之后只需推进尾部
+        unsigned* sq_array = (unsigned*)(base + p.sq_off.array);
+        for (unsigned i = 0; i < sq_entries; i++) sq_array[i] = i;
+        sqe_tail = *sq_tail;
+        sqe_submitted = sqe_tail;
+
+        cq_head = (unsigned*)(base + p.cq_off.head);
+        cq_tail = (unsigned*)(base + p.cq_off.tail);
+        cq_mask = *(unsigned*)(base + p.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe*)(base + p.cq_off.cqes);
+        return 0;
+    }
+
+    void destroy() {
+        if (fd < 0) return;
+        munmap(sqes, sqes_len);
+        munmap(ring_ptr, ring_len);
+        close(fd);
+        fd = -1;
+    }
+
+    // 提交队列中尚可填写的 SQE 数
+    unsigned sq_space() const {
+        return sq_entries - (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE));
+    }
+
+    // 取一个空闲的 SQE，提交队列满时先把已填写的 SQE 交给内核
+    struct io_uring_sqe* get_sqe() {
+        if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+            submit_and_wait(0, 0);
+            if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) return NULL;
+        }
+        struct io_uring_sqe* sqe = &sqes[sqe_tail & sq_mask];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe_tail++;
+        return sqe;
+    }
+
+    // 提交已填写的 SQE，并至多等待 timeout_ms 毫秒直到至少有 wait_nr 个完成事件
+    // 返回提交的 SQE 数；超时返回 -ETIME，被信号打断返回 -EINTR
+    int submit_and_wait(unsigned wait_nr, int timeout_ms) {
+        __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+        unsigned to_submit = sqe_tail - sqe_submitted;
+        if (to_submit == 0 && wait_nr == 0) return 0;
+
+        struct __kernel_timespec ts;
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+        struct io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(arg));
+        arg.ts = (uint64_t)(uintptr_t)&ts;
+
+        unsigned flags = IORING_ENTER_EXT_ARG;
+        if (wait_nr > 0) flags |= IORING_ENTER_GETEVENTS;
+        int ret = sys_io_uring_enter(fd, to_submit, wait_nr, flags, &arg, sizeof(arg));
+        if (ret < 0) return -errno;
+        sqe_submitted += ret;
+        return ret;
+    }
+
+    // 取下一个完成事件，没有则返回 NULL；处理完后须调用 cqe_seen()
+    struct io_uring_cqe* peek_cqe() {
+        unsigned head = *cq_head;
+        if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) return NULL;
+        return &cqes[head & cq_mask];
+    }
+
+    void cqe_seen() {
+        __atomic_store_n(cq_head, *cq_head + 1, __ATOMIC_RELEASE);
+    }
+};
+
+// 提供缓冲环（provided buffer ring）
+// 内核在 recv 完成时从环中挑选一块缓冲写入数据，并在完成事件中返回缓冲编号；
+// 用户处理完数据后把缓冲归还到环中。
+struct UringBufRing {
+    struct io_uring_buf_ring* br;
+    char* pool;
+    unsigned entries;   // 缓冲块数，须为 2 的幂
+    unsigned buf_size;  // 每块缓冲的字节数
+    uint16_t bgid;      // 缓冲组编号
+    size_t br_len;
+
+    // 分配缓冲并注册到 ring，失败返回负的 errno
+    int init(Uring& ring, uint16_t group, unsigned count, unsigned size) {
+        entries = count;
+        buf_size = size;
+        bgid = group;
+        br_len = entries * sizeof(struct io_uring_buf);
+        br = (struct io_uring_buf_ring*)mmap(NULL, br_len, PROT_READ | PROT_WRITE,
+                                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (br == MAP_FAILED) return -errno;
+        pool = (char*)mmap(NULL, (size_t)entries * buf_size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pool == MAP_FAILED) {
+            int err = -errno;
+            munmap(br, br_len);
+            return err;
+        }
+
+        struct io_uring_buf_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = (uint64_t)(uintptr_t)br;
+        reg.ring_entries = entries;
+        reg.bgid = bgid;
+        if (sys_io_uring_register(ring.fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            int err = -errno;
+            munmap(pool, (size_t)entries * buf_size);
+            munmap(br, br_len);
+            return err;
+        }
+
+        br->tail = 0;
+        for (unsigned i = 0; i < entries; i++) {
+            recycle((uint16_t)i);
+        }
+        return 0;
+    }
+
+    void destroy() {
+        munmap(pool, (size_t)entries * buf_size);
+        munmap(br, br_len);
+    }
+
+    // 缓冲编号对应的地址
+    char* buffer(uint16_t bid) const {
+        return pool + (size_t)bid * buf_size;
+    }
+
+    // 把缓冲归还到环中
+    void recycle(uint16_t bid) {
+        uint16_t tail = br->tail;
+        // 不使用 br->bufs：内核头文件的柔性数组宏在 C++ 下会引入额外的偏移，缓冲项实际从环的起始处排列
+        struct io_uring_buf* buf = (struct io_uring_buf*)br + (tail & (entries - 1));
+        buf->addr = (uint64_t)(uintptr_t)buffer(bid);
+        buf->len = buf_size;
+        buf->bid = bid;
+        __atomic_store_n(&br->tail, (uint16_t)(tail + 1), __ATOMIC_RELEASE);
+    }
+};
+
+#endif // URING_H_
@@ -9,30 +9,86 @@
 #include <pthread.h>
 #include <sys/socket.h>
 #include <sys/epoll.h>
+#include <sys/uio.h>
+#include <sys/eventfd.h>
+#include <poll.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <signal.h>
-#include <queue>
+#include <sched.h>
+#include <limits.h>
 #include <mutex>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <string> 
+#include <memory>
+#include <atomic>
+#include <algorithm>
 
 #include "include/nlohmann/json.hpp"
 using json = nlohmann::json;
 
 #include "include/log.h" // 日志打印宏, 如 LOGD, LOGI, LOGW, LOGE, LOG_SYSERR
 #include "include/msghead.h" // 电文头定义
+#include "include/head_traits.h" // 电文头格式描述
+#include "include/byte_scan.h" // 分隔符模式的分隔符查找
+#include "include/recv_ring.h" // 接收缓冲
+#include "include/uring.h" // io_uring 系统调用封装
+#include "include/timer_wheel.h" // 重连定时器
+#include "include/mpsc_queue.h" // 发送队列
+#include "include/pool_alloc.h" // 发送路径的分级内存池
+#include "include/send_chain.h" // 发送缓冲链节点与追加
 
 #define SERVER_PORT 8002 // 用于监听连接请求的端口号
 #define MAX_EVENTS 10
 #define MAX_MESSAGE_SIZE 9999 // 最大电文长度
-#define MAX_MESSAGE_BODY_SIZE (MAX_MESSAGE_SIZE - MsgHead::get_head_length())
-#define BUFFER_SIZE (int)(MAX_MESSAGE_SIZE * 1.0) // 接收缓冲区大小，预留 0% 安全冗余
-#define RECONNECT_INTERVAL 5  // 秒
+#define MAX_MESSAGE_BODY_SIZE (MAX_MESSAGE_SIZE - WireHead::head_length - WireHead::terminator_length)
+#define BUFFER_SIZE (64 * 1024) // 接收缓冲大小，一次 recv() 可以读入多条电文
+#define RECONNECT_INITIAL_MS 200   // 首次重连的退避时间（毫秒）
+#define RECONNECT_MAX_MS 30000     // 重连退避时间上限（毫秒），连续失败时退避时间逐次翻倍直到此上限
+#define RECONNECT_JITTER_PCT 50    // 退避时间随机缩短的最大比例（%），避免多个对端同时重连
+#define RECONNECT_WHEEL_SLOTS 1024 // 重连时间轮的槽数，每槽 1 毫秒
+#define LISTEN_TOKEN UINT64_MAX // 监听套接字在 epoll_event.data.u64 中的标识
+#define ACCEPTOR_WAKE_TOKEN (UINT64_MAX - 1) // 主线程唤醒 eventfd 在 epoll_event.data.u64 中的标识
+#define REACTOR_WAKE_TOKEN (UINT64_MAX - 2) // 反应器唤醒 eventfd 在 epoll_event.data.u64 中的标识
+#define MAX_REACTORS 64 // 反应器线程数上限
+#define URING_ENTRIES 256       // 每个 io_uring 实例的提交队列长度
+#define URING_BUF_COUNT 64      // 每个反应器的接收提供缓冲块数，须为 2 的幂
+#define URING_BUF_SIZE 16384    // 每块接收提供缓冲的字节数
+#define URING_SEND_MAX_IOV 256  // io_uring 后端每个连接一次 sendmsg 聚合的缓冲节点数上限
+#define CONN_SEND_QUEUE_CAPACITY 4096   // 每个连接的发送队列容量，须为 2 的幂，队列满时生产者自己移入发送缓冲
+#define REACTOR_READY_CAPACITY 1024     // 每个反应器的待发送连接队列容量，须为 2 的幂且不小于连接数
+#define SEND_DRAIN_BATCH 64             // 反应器一次从发送队列取出的消息数上限
+#define SEND_GATHER_MAX_IOV IOV_MAX     // epoll 后端一次 sendmsg 聚合的缓冲节点数上限
+#define SEND_GATHER_BYTES (256 * 1024)  // 一次 sendmsg 聚合的字节数上限，超过内核发送缓冲的部分只会短写
+#define SEND_LIMIT_BYTES (64 * 1024 * 1024) // 每个连接待发送数据的默认字节上限（发送队列与发送缓冲链之和）
+#define SEND_LIMIT_MSGS 65536           // 每个连接待发送电文的默认条数上限
+#define SEND_BLOCK_WAIT_MS 100          // 阻塞策略下生产者每次等待的时长，之后重新检查连接状态
+#define DEFAULT_MSGID "TEST"            // 调用方未指定电文号时使用的电文号
+#define FRAG_MAX_PENDING 4              // 每个连接同时重组的分片消息数上限，超过时丢弃最早开始的一条
+#define FRAG_INITIAL_CAPACITY (64 * 1024)   // 分片重组缓冲的初始大小，不足时翻倍
+#define DEFAULT_SENDDC "L3"             // 连接未配置时使用的发送端 DC
+#define DEFAULT_RECVDC "L2"             // 连接未配置时使用的接收端 DC
+
+// 线路上使用的电文头格式（见 include/head_traits.h），可以在编译时以 -DWIRE_HEAD_TRAITS=BinaryHeadTraits 等替换
+#ifndef WIRE_HEAD_TRAITS
+#define WIRE_HEAD_TRAITS MsgHeadTraits
+#endif
+typedef WIRE_HEAD_TRAITS WireHead;
+typedef FrameCodec<WireHead> WireCodec;
+static_assert(WireCodec::max_body_length >= MAX_MESSAGE_SIZE - WireHead::head_length - WireHead::terminator_length,
+              "电文头的长度字段须能描述 MAX_MESSAGE_SIZE 字节的电文");
+
+// I/O 后端，启动时通过 -b 选择；以 -DUSE_IO_URING 编译时默认使用 io_uring
+enum IoBackend { IO_EPOLL, IO_URING };
+#ifdef USE_IO_URING
+#define DEFAULT_IO_BACKEND IO_URING
+#else
+#define DEFAULT_IO_BACKEND IO_EPOLL
+#endif
 
 // 连接结构体
 struct Commloop {
@@ -42,84 +98,318 @@ struct Commloop {
                     // - 当 as_server == 0 时代表要连接的远端服务器 IP
     int port;       // 远端服务器的端口号，当 as_server == 1 时无效
     int as_server;  // 1 表示被动连接，0 表示主动连接
+    char senddc[3]; // 本端发出电文的发送端 DC，两位字符，空串表示使用 DEFAULT_SENDDC
+    char recvdc[3]; // 本端发出电文的接收端 DC，两位字符，空串表示使用 DEFAULT_RECVDC
 };
 
-// 发送队列的消息结构
+// 消息标志
+#define MSG_FLAG_FRAMED 0x1     // data 已是带电文头的完整电文，原样发送，不再生成电文头
+#define MSG_FLAG_FRAGMENT 0x2   // 大消息的一个分片，电文头中标记 frag_id、frag_index
+#define MSG_FLAG_LAST_FRAGMENT 0x4  // 大消息的最后一个分片
+
+// 发送队列的消息结构，消息持有电文体，随消息移交给发送缓冲链
 struct Message {
-    char* data;         // 待发送数据，不包含电文头
-    int length;         // 数据长度
-    int target_index;   // 在 g_connections 数组中的目标下标
+    char* data;             // 待发送数据，不包含电文头；带 MSG_FLAG_FRAMED 时为完整电文
+    int length;             // 数据长度
+    int target_index;       // 在 g_connections 数组中的目标下标
+    int flags;              // MSG_FLAG_*
+    char msgid[4];          // 电文号，首字节为 '\0' 时使用连接模板中的默认电文号
+    unsigned short frag_id;     // 分片消息号，带 MSG_FLAG_FRAGMENT 时有效
+    unsigned short frag_index;  // 分片序号，带 MSG_FLAG_FRAGMENT 时有效
+    BodyRelease release;    // 电文体的释放函数
+    void* release_ctx;
+};
+
+// 发送缓冲链节点（见 include/send_chain.h），结束符为 WireHead::terminator()
+typedef SendBufferNode<WireHead::head_type> SendBuffer;
+
+// 批量入队的一条消息，电文体的所有权与 add_to_send_queue_buffer() 相同
+struct BatchSendItem {
+    int conn_index;         // 在 g_connections 数组中的目标下标
+    char* data;             // 电文体，不包含电文头
+    size_t length;
+    BodyRelease release;    // 发送完毕、被丢弃或入队失败时调用，为 NULL 表示调用方自行管理
+    void* release_ctx;
+    const char* msgid;      // 4 个字符的电文号，为 NULL 时使用默认电文号
+};
+
+// 连接待发送的数据超过上限时的处理策略
+enum OverflowPolicy {
+    OVERFLOW_BLOCK,         // 阻塞生产者直到有空间；在反应器线程中调用时按 OVERFLOW_FAIL 处理，避免反应器等待自己
+    OVERFLOW_FAIL,          // 入队接口立即返回失败
+    OVERFLOW_DROP_OLDEST,   // 丢弃缓冲链中最早的尚未开始发送的电文，为新电文腾出空间
+    OVERFLOW_DROP_NEWEST,   // 丢弃新电文，入队接口仍返回成功
+};
+
+// 每个连接待发送数据的上限与水位，字节数按电文（含电文头）计算
+struct SendQueueLimits {
+    size_t max_bytes;
+    size_t max_msgs;
+    size_t high_bytes;      // 达到任一高水位时通知一次
+    size_t high_msgs;
+    size_t low_bytes;       // 高水位之后回落到两个低水位以下时通知一次
+    size_t low_msgs;
+    OverflowPolicy policy;
+};
+
+// 连接待发送数据的深度
+struct SendQueueDepth {
+    size_t bytes;           // 发送队列与发送缓冲链中尚未写完的电文字节数
+    size_t msgs;
+    uint64_t dropped;       // 因超过上限被丢弃的电文数
+    bool above_high;        // 是否处于高水位
+};
+
+// 水位通知，high 为 true 表示达到高水位，false 表示回落到低水位
+// 高水位在入队的生产者线程中通知；低水位在发送的线程中持有 send_mutexes[conn_index] 时通知，回调中不能调用发送接口
+typedef void (*WatermarkCallback)(int conn_index, bool high, size_t bytes, size_t msgs);
+
+// 广播时选择目标连接的谓词，返回 true 表示向该连接发送
+typedef bool (*ConnPredicate)(int conn_index, const Commloop& conn, void* ctx);
+
+// 被拆分为多段发送的电文体，各段共享调用方移交的同一块数据，最后一段释放后才调用原释放函数
+struct SharedBody {
+    std::atomic<int> refs;  // 尚未释放的段数
+    char* data;             // 调用方移交的整块数据
+    BodyRelease release;
+    void* release_ctx;
 };
 
-// 发送缓冲链
-struct SendBuffer {
-    char* data;         // 当前节点的待发送数据，已经包含电文头
-    int total_length;   // 当前节点的数据总长度
-    int sent_bytes;     // 已发送的字节数
-    struct SendBuffer* next;
+// 一条正在重组的分片消息
+struct Reassembly {
+    bool active;        // 是否正在重组
+    int id;             // 分片消息号
+    int next_index;     // 期望的下一个分片序号
+    uint64_t started;   // 开始重组的次序，同时重组的消息过多时淘汰最早的一条
+    char* data;         // 已收到的分片依次拼接，malloc 分配
+    size_t length;
+    size_t capacity;
 };
 
 // 每个连接的接收缓冲
-struct ReceiveBuffer {
-    char data[BUFFER_SIZE];
-    int received_bytes;
-    int expected_length;
-    bool header_received;
+typedef RecvRing<BUFFER_SIZE> ReceiveBuffer;
+static_assert(BUFFER_SIZE >= 2 * MAX_MESSAGE_SIZE, "接收缓冲至少应能容纳两条最大电文");
+static_assert(BUFFER_SIZE >= MAX_MESSAGE_SIZE + URING_BUF_SIZE, "接收缓冲须能在半条电文之后放下一整块提供缓冲");
+
+// 反应器：一个事件循环线程及其独占的 epoll 或 io_uring 实例，负责分配给它的那部分连接的收发
+struct Reactor {
+    int id;
+    int epoll_fd;
+    pthread_t tid;
+    std::atomic<int> load;  // 当前分配到该反应器的连接数
+    int wake_fd;            // eventfd，其他线程写入它来唤醒反应器
+
+    // 有待发送消息的连接；生产者入队后使 ready_signaled 由 false 变为 true 时才写 wake_fd，
+    // 反应器取 ready 队列之前把它清回 false
+    MpscQueue<int, REACTOR_READY_CAPACITY> ready;
+    std::atomic<bool> ready_signaled;
+
+    // 以下仅用于 io_uring 后端
+    Uring ring;
+    UringBufRing bufs;                  // 多发 recv 使用的提供缓冲
+    pthread_mutex_t pending_mutex;      // 保护下面两个待处理列表
+    std::vector<int> pending_attach;    // 等待开始接收的新连接
+    std::vector<int> pending_flush;     // 有新数据等待发送的连接
+};
+
+// io_uring 后端下每个连接的在途请求状态，只由所属反应器线程访问
+struct UringConnState {
+    int ops;            // 在途请求数（多发 recv 与发送），归零之前不能释放连接的缓冲和套接字
+    bool sending;       // 有在途的 sendmsg，同一时刻每个连接至多一个
+    bool send_failed;   // 发送出错
+    bool closing;       // 已决定关闭，等待在途请求结束
+    struct msghdr send_msg;                     // 在途 sendmsg 的参数，须保持到完成
+    struct iovec send_iov[URING_SEND_MAX_IOV];
 };
 
+// io_uring 请求类型，编码在 user_data 中
+enum UringOp { UOP_ACCEPT = 1, UOP_WAKE, UOP_RECV, UOP_SEND, UOP_CONNECT };
+
 // 全局连接数组
 // 当 as_server == 1 时，表示被动连接，本端作为服务端，等待远端连接。每一个远端连接占用这样的一个条目（插槽）
 // 当 as_server == 0 时，表示主动连接，本端作为客户端，主动连接远端服务器
 Commloop g_connections[] = {
-    {-1, "127.0.0.1", 0, 1},   // 本机作为服务端监听 lo，插槽 #0
-    {-1, "127.0.0.1", 0, 1},   // 本机作为服务端监听 lo，插槽 #1
-    {-1, "127.0.0.1", 0, 1},   // 本机作为服务端监听 lo，插槽 #2
-    {-1, "127.0.0.1", 0, 1},   // 本机作为服务端监听 lo，插槽 #3
-    {-1, "127.0.0.1", 0, 1},   // 本机作为服务端监听 lo，插槽 #4
-    {-1, "192.168.199.1", 0, 1},   // 本机作为服务端监听 NetAssist
-    {-1, "192.168.199.1", 8080, 0},    // 本机作为客户端，连接 NetAssist
+    {-1, "127.0.0.1", 0, 1, "L3", "L2"},   // 本机作为服务端监听 lo，插槽 #0
+    {-1, "127.0.0.1", 0, 1, "L3", "L2"},   // 本机作为服务端监听 lo，插槽 #1
+    {-1, "127.0.0.1", 0, 1, "L3", "L2"},   // 本机作为服务端监听 lo，插槽 #2
+    {-1, "127.0.0.1", 0, 1, "L3", "L2"},   // 本机作为服务端监听 lo，插槽 #3
+    {-1, "127.0.0.1", 0, 1, "L3", "L2"},   // 本机作为服务端监听 lo，插槽 #4
+    {-1, "192.168.199.1", 0, 1, "L3", "L2"},   // 本机作为服务端监听 NetAssist
+    {-1, "192.168.199.1", 8080, 0, "L3", "L2"},    // 本机作为客户端，连接 NetAssist
 };
 
 // 全局变量
 static const int g_connections_len = sizeof(g_connections) / sizeof(Commloop);
 static int server_fd = -1;
-static int epoll_fd = -1;
+static int listen_epoll_fd = -1;   // 监听套接字所在的 epoll 实例，由主线程等待
 static bool running = true;
-// 互斥锁保护 g_connections 数组及相关资源（如 socket、接收/发送缓冲区）
+// 互斥锁保护 g_connections 数组中插槽的分配与释放（socket 字段、所属反应器）
 static pthread_mutex_t connections_mutex = PTHREAD_MUTEX_INITIALIZER;
-// 互斥锁保护发送队列
-static pthread_mutex_t send_queue_mutex = PTHREAD_MUTEX_INITIALIZER;
-// 发送队列条件变量
-static pthread_cond_t  send_queue_cv    = PTHREAD_COND_INITIALIZER;
+// 每个连接一把互斥锁，保护该连接的发送缓冲链及套接字上的写操作
+static pthread_mutex_t send_mutexes[g_connections_len];
 
 // 生命周期条件变量。用于替代 sleep 的定时等待，实现退出时的即时唤醒
 static pthread_mutex_t lifecycle_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  lifecycle_cv    = PTHREAD_COND_INITIALIZER;
 
 // 发送队列与缓冲
-static std::queue<Message> send_queue;                          // 发送队列
+// 每个连接的发送队列：生产者无锁入队，由连接所属的反应器批量取出、组装电文并发送
+static MpscQueue<Message, CONN_SEND_QUEUE_CAPACITY> conn_send_queues[g_connections_len];
+// 连接是否已登记到反应器的 ready 队列，保证每个连接在 ready 队列中至多出现一次
+static std::atomic<bool> conn_send_scheduled[g_connections_len];
+static_assert(g_connections_len <= REACTOR_READY_CAPACITY, "反应器的待发送连接队列须能容纳全部连接");
+// 批量入队时新登记、尚未放入 ready 队列的连接，整批入队完成后一次性放入并唤醒各反应器
+struct ReadyBatch {
+    int count;
+    int conns[g_connections_len];       // 每个连接至多登记一次
+    int reactors[g_connections_len];    // 登记时连接所属的反应器
+};
 static SendBuffer* send_buffers[g_connections_len] = {};        // 每个连接的发送缓冲链头指针
+static SendBuffer* send_buffer_tails[g_connections_len] = {};   // 每个连接的发送缓冲链尾指针，链为空时为 NULL
+// 每个连接的电文头模板，启动时按连接配置预置电文号与 DC，组装电文时拷贝后只改写长度、日期时间与序列号
+static WireHead::head_type conn_head_templates[g_connections_len];
+// 每个连接已分配的最后一个电文序列号，只在持有 send_mutexes[conn_index] 组装电文时递增，
+// 因此不需要额外的锁或原子操作；重连后继续递增，写入电文头时对 1000000 取模
+static uint64_t conn_send_seqnos[g_connections_len] = {};
+// 每个连接待发送的字节数与电文数，入队时增加，写完或丢弃时减少
+static std::atomic<size_t> conn_queued_bytes[g_connections_len];
+static std::atomic<size_t> conn_queued_msgs[g_connections_len];
+static std::atomic<uint64_t> conn_dropped_msgs[g_connections_len];
+static std::atomic<bool> conn_above_high[g_connections_len];
+static SendQueueLimits conn_send_limits[g_connections_len];     // 应在连接开始发送之前设置
+static WatermarkCallback watermark_callback = NULL;
+// 阻塞策略下等待空间的生产者，与 send_mutexes[i] 配合使用
+static pthread_cond_t send_space_cvs[g_connections_len];
+static int send_space_waiters[g_connections_len];               // 由 send_mutexes[i] 保护
+// 缓冲链头部已交给在途 sendmsg 的节点数，这些节点不能被丢弃，由 send_mutexes[i] 保护
+static int send_pinned_nodes[g_connections_len];
 static ReceiveBuffer receive_buffers[g_connections_len];
+// 每个连接正在重组的分片消息，与接收缓冲一样只由连接所属的反应器访问，在接收缓冲重置时一起清空
+static Reassembly reassemblies[g_connections_len][FRAG_MAX_PENDING];
+static uint64_t reassembly_starts[g_connections_len];
+// 下一个分片消息号，对 WireHead::fragment_ids 取模后使用；各连接共用，广播的各目标连接得到相同的分片消息号
+static std::atomic<uint32_t> next_fragment_id(0);
+// 每个插槽的代数，插槽每次绑定或释放套接字时加一
+// 注册到 epoll 的句柄携带注册时的代数，用于识别插槽已被重新分配后仍残留的旧事件
+static std::atomic<uint32_t> conn_generations[g_connections_len];
+
+// 反应器线程池
+static Reactor reactors[MAX_REACTORS];
+static int g_reactor_count = 0;
+static thread_local Reactor* tls_reactor = NULL;   // 当前线程运行的反应器，非反应器线程为 NULL
+static std::atomic<int> conn_reactors[g_connections_len];  // 每个连接所属的反应器下标，-1 表示未分配
+// 主动连接的非阻塞 connect() 是否尚未完成，由 send_mutexes[i] 保护
+// 连接完成之前发送缓冲中的数据只缓存不发送
+static bool conn_connecting[g_connections_len] = {};
+static IoBackend g_io_backend = DEFAULT_IO_BACKEND;
+static UringConnState uring_conns[g_connections_len];
+static_assert(g_connections_len < (1 << 24), "io_uring user_data 中连接下标只占 24 位");
+
+// 主动连接的重连调度，时间轮及退避状态只由主线程访问
+// 其他线程发现主动连接断开或连接失败时，把请求放入 pending_reconnects 并写 acceptor_wake_fd 唤醒主线程
+static TimerWheel<RECONNECT_WHEEL_SLOTS> reconnect_wheel;
+static TimerNode reconnect_timers[g_connections_len];
+static int reconnect_attempts[g_connections_len];   // 连续失败的次数，决定下一次的退避时间
+static unsigned int reconnect_seed;                 // 退避抖动的随机数种子
+static int acceptor_wake_fd = -1;
+static pthread_mutex_t reconnect_mutex = PTHREAD_MUTEX_INITIALIZER;    // 保护 pending_reconnects
+static std::vector<std::pair<int, bool> > pending_reconnects;          // (连接下标, 是否为连接失败)
 
 // 函数声明
 void dummy_function();
 static inline void my_sleep_seconds(int seconds);
 void signal_handler(int sig);
 int create_server_socket();
-int create_client_socket(const char* ip, int port);
+int create_client_socket(const char* ip, int port, bool* in_progress);
 void set_nonblocking(int sock);
-void* connection_manager_thread(void* arg);
-void* send_thread(void* arg);
+static inline uint64_t monotonic_ms();
+static int reconnect_delay_ms(int attempts);
+static void schedule_reconnect(int conn_index, bool connect_failed);
+static void request_reconnect(int conn_index, bool connect_failed);
+static void on_reconnect_timer(TimerNode* timer);
+static void run_reconnect_timers();
+void* reactor_thread(void* arg);
+static void reactor_loop_epoll(Reactor* reactor);
+static void reactor_loop_uring(Reactor* reactor);
+static void run_acceptor_epoll();
+static void run_acceptor_uring();
+void handle_connection_event(uint64_t token, uint32_t events);
+static inline uint64_t make_uring_data(UringOp op, int conn_index);
+static bool init_uring_reactor(Reactor* reactor);
+static void destroy_uring_reactor(Reactor* reactor);
+static void wake_reactor(Reactor* reactor);
+static void signal_reactor(Reactor* reactor);
+static void request_flush(int conn_index);
+static void uring_arm_recv(Reactor* reactor, int conn_index);
+static void uring_arm_connect_poll(Reactor* reactor, int conn_index);
+static void uring_on_connect(Reactor* reactor, const struct io_uring_cqe* cqe);
+static void uring_flush(Reactor* reactor, int conn_index);
+static void uring_begin_close(int conn_index);
+static void uring_on_wake(Reactor* reactor);
+static void uring_on_recv(Reactor* reactor, const struct io_uring_cqe* cqe);
+static void uring_on_send(Reactor* reactor, const struct io_uring_cqe* cqe);
+static int pick_reactor();
+static void attach_to_reactor(int conn_index);
+static void detach_from_reactor(int conn_index);
+static bool push_send_queue(const Message& msg, ReadyBatch* batch = NULL, bool reserved = false);
+static void post_ready_batch(const ReadyBatch* batch);
+static void drain_conn_send_queue(int conn_index);
+static void send_ready_connection(Reactor* reactor, int conn_index);
+static void drain_ready_queue(Reactor* reactor);
 void* get_sendmsg_thread(void* arg);
-int find_connection_by_socket(int socket);
+static inline uint64_t make_conn_token(int conn_index);
+static inline int resolve_conn_token(uint64_t token);
 int find_connection_by_ip_and_type(const char* ip, int as_server);
 void handle_new_connection(int server_fd);
+void admit_passive_connection(int client_sock, const struct sockaddr_in* client_addr);
 void handle_client_data(int conn_index);
+int parse_frames(int conn_index, const char* data, int length);
+bool feed_received_bytes(int conn_index, const char* data, int length);
 void handle_client_disconnect(int conn_index);
 bool connect_to_server(int conn_index);
-void add_to_send_buffer(int conn_index, const char* data, int length);
+bool finish_connect(int conn_index);
+void add_to_send_buffer(int conn_index, const Message& msg);
+static void release_pool_body(char* data, void* ctx);
+static void log_pool_stats();
+static inline void release_message(const Message& msg);
+static void free_send_buffer(SendBuffer* buffer);
 bool send_buffered_data(int conn_index);
-bool add_to_send_queue_std_string(int conn_index, const std::string& data);
+static int gather_send_iov(int conn_index, struct iovec* iov, int max_iov, size_t* total, int* nodes);
+static inline size_t message_wire_bytes(const Message& msg);
+static int reserve_send_space(int conn_index, size_t bytes, size_t msgs = 1);
+static int reserve_fragment_space(int conn_index, size_t length, int chunks);
+static void release_fragment_space(int conn_index, size_t length, int from_chunk, int chunks);
+static bool wait_send_space(int conn_index, size_t bytes, size_t msgs);
+static bool drop_oldest_buffers(int conn_index, size_t bytes, size_t msgs);
+static void release_send_space(int conn_index, size_t bytes, size_t msgs);
+bool set_send_queue_limits(int conn_index, const SendQueueLimits& limits);
+void set_send_watermark_callback(WatermarkCallback callback);
+bool get_send_queue_depth(int conn_index, SendQueueDepth* depth);
+static void consume_sent_bytes(int conn_index, size_t sent);
+bool add_to_send_queue_std_string(int conn_index, const std::string& data, const char* msgid = NULL);
+bool add_to_send_queue_std_string(int conn_index, std::string&& data, const char* msgid = NULL);
+bool add_to_send_queue_buffer(int conn_index, std::unique_ptr<char[]> data, size_t length, const char* msgid = NULL);
+bool add_to_send_queue_buffer(int conn_index, char* data, size_t length, BodyRelease release, void* release_ctx,
+                              const char* msgid = NULL);
+static bool enqueue_body(int conn_index, char* data, size_t length, BodyRelease release, void* release_ctx,
+                         const char* msgid, ReadyBatch* batch);
+static void build_head_template(int conn_index);
+static bool plan_fragments(size_t length, int* chunks, int* frag_id);
+static inline void mark_fragment(Message* msg, int frag_id, int index, int chunks);
+static void reset_reassembly(int conn_index);
+static void reassemble_fragment(int conn_index, const FragmentInfo& frag, const char* body, int body_len);
+static bool copy_msgid(char* out, const char* msgid);
+static bool body_fits_delimited(const char* data, size_t length);
+size_t add_to_send_queue_batch(const BatchSendItem* items, size_t count, bool log_each = false);
+size_t add_to_send_queue_batch(std::vector<std::pair<int, std::string>>&& items, bool log_each = false);
+static void release_shared_body(char* data, void* ctx);
+static void release_new_array(char* data, void* ctx);
+static void release_moved_string(char* data, void* ctx);
+bool add_to_send_queue_framed(int conn_index, char* frame, size_t length, BodyRelease release, void* release_ctx);
+bool add_to_send_queue_framed(int conn_index, std::string&& frame);
+static bool validate_frame_length(const char* frame, size_t length);
+int broadcast_send(const int* conn_indices, int count, const char* data, size_t length, const char* msgid = NULL);
+int broadcast_send_if(ConnPredicate pred, void* ctx, const char* data, size_t length, const char* msgid = NULL);
 void process_received_message(int conn_index, const char* data, int length);
 void cleanup_connection(int conn_index, bool try_flush);
 std::vector<Commloop> load_connections(const std::string& filename);
@@ -136,6 +426,13 @@ static inline void my_sleep_seconds(int seconds) {
     pthread_mutex_unlock(&lifecycle_mutex);
 }
 
+// 单调时钟的毫秒数，用于重连定时器
+static inline uint64_t monotonic_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
 // 信号处理
 void signal_handler(int sig) {
     LOGI("收到信号 %d，正在退出...", sig);
@@ -185,8 +482,9 @@ int create_server_socket() {
     return sock;
 }
 
-// 创建客户端套接字并连接服务器
-int create_client_socket(const char* ip, int port) {
+// 创建客户端套接字并以非阻塞方式发起连接
+// 连接立即完成时 *in_progress 为 false；否则为 true，连接结果由所属反应器在套接字可写时通过 SO_ERROR 获知
+int create_client_socket(const char* ip, int port, bool* in_progress) {
     int sock = socket(AF_INET, SOCK_STREAM, 0);
     if (sock < 0) {
         LOG_SYSERR("socket");
@@ -205,16 +503,21 @@ int create_client_socket(const char* ip, int port) {
         return -1;
     }
 
+    // 设置非阻塞模式后再发起连接，不可达的对端不会阻塞调用线程直到 SYN 超时
+    set_nonblocking(sock);
+
     // 尝试连接到服务器
+    *in_progress = false;
     if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        LOG_SYSERR("connect");
-        close(sock);
-        return -1;
+        if (errno != EINPROGRESS) {
+            LOG_SYSERR("connect");
+            close(sock);
+            return -1;
+        }
+        *in_progress = true;
     }
 
-    // 设置非阻塞模式
-    set_nonblocking(sock);
-    LOGI("已连接到 %s:%d，套接字描述符: %d", ip, port, sock);
+    LOGI("%s %s:%d，套接字描述符: %d", *in_progress ? "正在连接" : "已连接到", ip, port, sock);
     return sock;
 }
 
@@ -224,14 +527,19 @@ void set_nonblocking(int sock) {
     fcntl(sock, F_SETFL, flags | O_NONBLOCK);
 }
 
-// 通过套接字描述符查找连接下标
-int find_connection_by_socket(int socket) {
-    for (int i = 0; i < g_connections_len; i++) {
-        if (g_connections[i].socket == socket) {
-            return i;
-        }
-    }
-    return -1;
+// 生成注册到 epoll_event.data.u64 的连接句柄：高 32 位为插槽代数，低 32 位为插槽下标
+static inline uint64_t make_conn_token(int conn_index) {
+    return ((uint64_t)conn_generations[conn_index].load() << 32) | (uint32_t)conn_index;
+}
+
+// 由连接句柄得到连接下标，O(1)
+// 句柄的代数与插槽当前代数不一致，说明事件属于已经关闭的旧套接字（描述符可能已被复用），返回 -1
+static inline int resolve_conn_token(uint64_t token) {
+    uint32_t conn_index = (uint32_t)token;
+    if (conn_index >= (uint32_t)g_connections_len) return -1;
+    if ((uint32_t)(token >> 32) != conn_generations[conn_index].load()) return -1;
+    if (g_connections[conn_index].socket == -1) return -1;
+    return (int)conn_index;
 }
 
 // 通过 IP 与类型查找并分配连接下标
@@ -273,8 +581,13 @@ void handle_new_connection(int server_fd) {
         return;
     }
 
+    admit_passive_connection(client_sock, &client_addr);
+}
+
+// 为已接受的被动连接分配插槽并交给反应器，不匹配任何插槽时关闭套接字
+void admit_passive_connection(int client_sock, const struct sockaddr_in* client_addr) {
     char client_ip[INET_ADDRSTRLEN];
-    inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+    inet_ntop(AF_INET, &client_addr->sin_addr, client_ip, INET_ADDRSTRLEN);
 
     // 在 g_connections 中查找匹配的连接
     pthread_mutex_lock(&connections_mutex);
@@ -288,38 +601,89 @@ void handle_new_connection(int server_fd) {
     }
 
     if (g_connections[conn_index].socket != -1) {
-        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, g_connections[conn_index].socket, NULL);
+        detach_from_reactor(conn_index);
         close(g_connections[conn_index].socket);
     }
 
+    // 初始化接收缓冲，须在交给反应器之前完成
+    receive_buffers[conn_index].reset();
+    reset_reassembly(conn_index);
+
     g_connections[conn_index].socket = client_sock;
+    conn_generations[conn_index]++;
     set_nonblocking(client_sock);
 
-    // 加入 epoll
+    // 交给负载最小的反应器
+    attach_to_reactor(conn_index);
+
+    LOGI("已接受来自 %s 的被动连接，作为连接 %d，由反应器 %d 处理",
+         client_ip, conn_index, conn_reactors[conn_index].load());
+    // add_to_send_queue_std_string(conn_index, "hello");
+    pthread_mutex_unlock(&connections_mutex);
+}
+
+// 选出当前负载（连接数）最小的反应器
+static int pick_reactor() {
+    int best = 0;
+    for (int r = 1; r < g_reactor_count; r++) {
+        if (reactors[r].load.load() < reactors[best].load.load()) {
+            best = r;
+        }
+    }
+    return best;
+}
+
+// 把已绑定套接字的连接交给负载最小的反应器，调用时需持有 connections_mutex 锁
+// 注册到 epoll 后反应器线程随时可能开始处理该连接，因此连接的其余状态须在调用前初始化完毕
+static void attach_to_reactor(int conn_index) {
+    int r = pick_reactor();
+    conn_reactors[conn_index] = r;
+    reactors[r].load++;
+
+    if (g_io_backend == IO_URING) {
+        // io_uring 自行完成异步等待，套接字恢复为阻塞模式
+        int sock = g_connections[conn_index].socket;
+        fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) & ~O_NONBLOCK);
+        // 提交队列只能由反应器线程操作，这里只登记连接并唤醒反应器，由反应器开始接收
+        pthread_mutex_lock(&reactors[r].pending_mutex);
+        reactors[r].pending_attach.push_back(conn_index);
+        pthread_mutex_unlock(&reactors[r].pending_mutex);
+        wake_reactor(&reactors[r]);
+        return;
+    }
+
     struct epoll_event ev;
     // NOTE
-    // 在被动连接中，当 EPOLLOUT 事件触发时，如果 send_thread 尚未将队列中的消息添加到 send_buffers 中，
+    // 在被动连接中，当 EPOLLOUT 事件触发时，如果反应器尚未将连接发送队列中的消息添加到 send_buffers 中，
     // 那么 send_buffered_data 会发现缓冲为空，无法发送数据。
     // 在程序中主动发送消息的流程如下：
-    // 1. 调用 add_to_send_queue_std_string 将消息加入 send_queue
-    // 2. 等待 send_thread 线程将消息从 send_queue 移动到 send_buffers
+    // 1. 调用 add_to_send_queue_std_string 将消息加入连接的发送队列，并通过 wake_fd 唤醒所属反应器
+    // 2. 反应器将消息从发送队列移动到 send_buffers
     // 3. 等待 epoll 触发 EPOLLOUT 事件，调用 send_buffered_data 发送数据
     // 如果采用边缘触发，那么直到下次写操作失败导致不可写状态，恢复可写状态时才会发送这个消息，造成发送延迟。
     // 经过调试，当连接有数据可读时，EPOLLIN 会触发，同时 EPOLLOUT 也会触发。从而，上面的情况下，消息延迟会等到下一次接收数据时才发送。
-    // 目前的解决方案是：send_thread 中处理消息后立即尝试发送一次数据
+    // 目前的解决方案是：反应器把消息移动到 send_buffers 后立即尝试发送一次数据
     ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
-    ev.data.fd = client_sock;
-    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_sock, &ev);
-
-    // 初始化接收缓冲
-    memset(&receive_buffers[conn_index], 0, sizeof(ReceiveBuffer));
+    ev.data.u64 = make_conn_token(conn_index);
+    if (epoll_ctl(reactors[r].epoll_fd, EPOLL_CTL_ADD, g_connections[conn_index].socket, &ev) < 0) {
+        LOG_SYSERR("epoll_ctl");
+    }
+}
 
-    LOGI("已接受来自 %s 的被动连接，作为连接 %d", client_ip, conn_index);
-    // add_to_send_queue_std_string(conn_index, "hello");
-    pthread_mutex_unlock(&connections_mutex);
+// 把连接从所属反应器中移除，调用时需持有 connections_mutex 锁
+// io_uring 后端下只能在连接的在途请求全部结束后调用
+static void detach_from_reactor(int conn_index) {
+    int r = conn_reactors[conn_index];
+    if (r < 0) return;
+    if (g_io_backend == IO_EPOLL) {
+        epoll_ctl(reactors[r].epoll_fd, EPOLL_CTL_DEL, g_connections[conn_index].socket, NULL);
+    }
+    reactors[r].load--;
+    conn_reactors[conn_index] = -1;
 }
 
 // 处理连接上的数据
+// 每次 recv() 尽可能填满接收缓冲，然后一次性解析出其中所有完整的电文
 void handle_client_data(int conn_index) {
     ReceiveBuffer* rb = &receive_buffers[conn_index];
     int sock = g_connections[conn_index].socket;
@@ -329,21 +693,11 @@ void handle_client_data(int conn_index) {
         if (!running) {
             break;
         }
-        int bytes_to_read;
-        int read_offset;
-        int head_len = MsgHead::get_head_length();
+        // 保证尾部至少能放下一条最大电文，否则把残余的半条电文搬到缓冲起始处
+        rb->reserve(MAX_MESSAGE_SIZE);
+        int bytes_to_read = rb->writable();
 
-        if (!rb->header_received) {
-            // 读取消息头
-            bytes_to_read = head_len - rb->received_bytes;
-            read_offset = rb->received_bytes;
-        } else {
-            // 读取消息体
-            bytes_to_read = rb->expected_length - rb->received_bytes;
-            read_offset = rb->received_bytes;
-        }
-
-        int bytes_read = recv(sock, rb->data + read_offset, bytes_to_read, 0);
+        int bytes_read = recv(sock, rb->write_ptr(), bytes_to_read, 0);
 
         if (bytes_read <= 0) {
             if (bytes_read == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
@@ -353,34 +707,208 @@ void handle_client_data(int conn_index) {
             break;
         }
 
-        rb->received_bytes += bytes_read;
-        if (rb->header_received) {
-            LOGI("尝试从连接 %d 读取，%d/%d", conn_index , rb->received_bytes, rb->expected_length);
+        rb->commit(bytes_read);
+        LOGD("从连接 %d 读取 %d 字节，待解析 %d 字节", conn_index, bytes_read, rb->readable());
+
+        // 由于发送方发送的电文出错，导致长度异常，作断开连接处理，以保证本程序正常运行
+        int consumed = parse_frames(conn_index, rb->read_ptr(), rb->readable());
+        if (consumed < 0) {
+            handle_client_disconnect(conn_index);
+            break;
+        }
+        rb->consume(consumed);
+
+        // 对流式套接字，读到的字节数少于请求的字节数说明内核接收缓冲已读空，
+        // 无需再用一次返回 EAGAIN 的 recv() 确认；之后到达的数据会重新触发 EPOLLIN
+        if (bytes_read < bytes_to_read) {
+            break;
+        }
+    }
+}
+
+// 分隔符模式下从 data 中解析出所有以分隔符结束的电文，去掉分隔符后逐条交给 process_received_message()
+// 只扫描上次没有扫描过的字节，多 KB 的电文体分多次到达时不重复扫描；空电文被忽略
+// 返回完整电文占用的字节数；超过 MAX_MESSAGE_BODY_SIZE 字节仍未出现分隔符时返回 -1
+static int parse_delimited_frames(int conn_index, const char* data, int length) {
+    ReceiveBuffer* rb = &receive_buffers[conn_index];
+    int offset = 0;
+    while (offset < length) {
+        int scanned = rb->scanned;
+        const char* end = scan_byte(data + offset + scanned, length - offset - scanned, WireHead::delimiter);
+        if (end == NULL) {
+            rb->scanned = length - offset;
+            if (rb->scanned > MAX_MESSAGE_BODY_SIZE) {
+                LOGW("连接 %d 的电文超过 %d 字节仍未出现分隔符，断开连接", conn_index, MAX_MESSAGE_BODY_SIZE);
+                return -1;
+            }
+            break;
+        }
+        int body_len = (int)(end - (data + offset));
+        if (body_len > MAX_MESSAGE_BODY_SIZE) {
+            LOGW("连接 %d 的电文长度异常（%d 字节），断开连接", conn_index, body_len);
+            return -1;
+        }
+        if (body_len > 0) {
+            process_received_message(conn_index, data + offset, body_len);
+        }
+        offset += body_len + 1;
+        rb->scanned = 0;
+    }
+    return offset;
+}
+
+// 从 data 中原地解析出所有完整的电文，逐条交给 process_received_message()
+// 返回完整电文占用的字节数，末尾不完整的电文留给调用者保存；电文头非法、长度或结束符异常时返回 -1
+// 电文头一接收完整就校验，非法的电文头不会等到电文体到齐、也不会被保存到接收缓冲
+// 带结束符的格式交付时去掉结束符
+int parse_frames(int conn_index, const char* data, int length) {
+    if constexpr (WireHead::delimited) {
+        return parse_delimited_frames(conn_index, data, length);
+    }
+    const int head_len = WireHead::head_length;
+    int offset = 0;
+
+    while (length - offset >= head_len) {
+        // 可以确定 data + offset 必然已经指向了一个完整的电文头
+        // 按编译期确定的电文头格式解码电文体长度，默认格式同时校验 length、date、time、seqno 均为数字
+        int body_len = WireCodec::body_length(data + offset);
+        if (body_len < 0) {
+            LOGW("连接 %d 的电文头非法，断开连接；电文头：%s", conn_index, HEX_DUMP(data + offset, head_len));
+            return -1;
+        }
+        if (body_len > MAX_MESSAGE_BODY_SIZE || body_len == 0) {
+            LOGW("连接 %d 的电文长度异常（%d 字节），断开连接", conn_index, body_len);
+            return -1;
+        }
+        int frame_len = WireCodec::frame_length(body_len);
+        if (length - offset < frame_len) {
+            break;  // 电文体尚未接收完整
         }
+        if constexpr (WireHead::terminator_length > 0 && WireHead::check_terminator) {
+            const char* terminator = data + offset + head_len + body_len;
+            if (memcmp(terminator, WireHead::terminator(), WireHead::terminator_length) != 0) {
+                LOGW("连接 %d 的电文结束符不符，断开连接；结束符：%s", conn_index,
+                     HEX_DUMP(terminator, WireHead::terminator_length));
+                return -1;
+            }
+        }
+        // 大消息的分片先拼接到重组缓冲，最后一片到达后才交付
+        if constexpr (WireHead::supports_fragments) {
+            FragmentInfo frag;
+            if (WireHead::parse_fragment(data + offset, &frag)) {
+                reassemble_fragment(conn_index, frag, data + offset + head_len, body_len);
+                offset += frame_len;
+                continue;
+            }
+        }
+        // 收到完整消息，电文体直接指向接收缓冲，无需拷贝
+        process_received_message(conn_index, data + offset + head_len, body_len);
+        offset += frame_len;
+    }
+    return offset;
+}
+
+// 丢弃连接上全部正在重组的分片消息，与接收缓冲一起在连接（重新）建立或断开时调用
+static void reset_reassembly(int conn_index) {
+    for (int i = 0; i < FRAG_MAX_PENDING; i++) {
+        Reassembly* r = &reassemblies[conn_index][i];
+        free(r->data);
+        r->data = NULL;
+        r->active = false;
+        r->length = 0;
+        r->capacity = 0;
+    }
+}
 
-        if (!rb->header_received && rb->received_bytes >= head_len) {
-            // 头部读取完成，解析消息长度
-            // 可以确定 rb->data 指针必然已经指向了一个完整的 MsgHead 结构
-            MsgHead* mh = (MsgHead*)rb->data;
-            // 调用这个完整的 MsgHead 结构的成员函数以获取消息体长度
-            rb->expected_length = mh->get_body_length();
-            rb->header_received = true;
-            rb->received_bytes = 0; // 重置用于读取消息体
+// 结束一条分片消息的重组并释放重组缓冲
+static void finish_reassembly(Reassembly* r) {
+    free(r->data);
+    r->data = NULL;
+    r->active = false;
+    r->length = 0;
+    r->capacity = 0;
+}
 
-            // 由于发送方发送的电文出错，导致长度异常，作断开连接处理，以保证本程序正常运行
-            if (rb->expected_length > MAX_MESSAGE_BODY_SIZE || rb->expected_length <= 0) {
-                LOGW("消息过大（%d 字节），断开连接", rb->expected_length);
-                handle_client_disconnect(conn_index);
-                break;
+// 收到一个分片：按序号拼接到所属分片消息的重组缓冲，最后一片到达后把完整消息交给 process_received_message() 一次
+// 序号不连续（中间的分片在发送方被丢弃，或对端乱序发送）时丢弃整条消息；不影响连接上的其他电文
+static void reassemble_fragment(int conn_index, const FragmentInfo& frag, const char* body, int body_len) {
+    Reassembly* slots = reassemblies[conn_index];
+    Reassembly* r = NULL;
+    for (int i = 0; i < FRAG_MAX_PENDING; i++) {
+        if (slots[i].active && slots[i].id == frag.id) {
+            r = &slots[i];
+            break;
+        }
+    }
+    if (frag.index == 0) {
+        if (r != NULL) {
+            LOGW("连接 %d 的分片消息 %d 未收完即重新开始，丢弃已收到的 %zu 字节", conn_index, frag.id, r->length);
+            finish_reassembly(r);
+        } else {
+            // 取空闲的重组槽，没有时淘汰最早开始的一条
+            r = &slots[0];
+            for (int i = 0; i < FRAG_MAX_PENDING && r->active; i++) {
+                if (!slots[i].active || slots[i].started < r->started) r = &slots[i];
             }
-        } else if (rb->header_received && rb->received_bytes >= rb->expected_length) {
-            // 收到完整消息
-            process_received_message(conn_index, rb->data, rb->expected_length);
+            if (r->active) {
+                LOGW("连接 %d 同时重组的分片消息超过 %d 条，丢弃分片消息 %d 已收到的 %zu 字节",
+                     conn_index, FRAG_MAX_PENDING, r->id, r->length);
+                finish_reassembly(r);
+            }
+        }
+        r->active = true;
+        r->id = frag.id;
+        r->next_index = 0;
+        r->started = ++reassembly_starts[conn_index];
+    } else if (r == NULL || frag.index != r->next_index) {
+        LOGW("连接 %d 的分片消息 %d 序号不连续（期望 %d，收到 %d），丢弃整条消息",
+             conn_index, frag.id, r != NULL ? r->next_index : 0, frag.index);
+        if (r != NULL) finish_reassembly(r);
+        return;
+    }
 
-            // 重置缓冲，准备下一条消息
-            memset(rb, 0, sizeof(ReceiveBuffer));
+    if (r->length + body_len > r->capacity) {
+        size_t capacity = std::max(r->capacity * 2, (size_t)FRAG_INITIAL_CAPACITY);
+        while (capacity < r->length + body_len) capacity *= 2;
+        char* data = (char*)realloc(r->data, capacity);
+        if (data == NULL) {
+            LOGE("连接 %d 的分片消息 %d 重组缓冲分配失败（%zu 字节），丢弃整条消息", conn_index, frag.id, capacity);
+            finish_reassembly(r);
+            return;
         }
+        r->data = data;
+        r->capacity = capacity;
+    }
+    memcpy(r->data + r->length, body, body_len);
+    r->length += body_len;
+    r->next_index++;
+
+    if (frag.last) {
+        LOGD("连接 %d 的分片消息 %d 重组完成，共 %d 片 %zu 字节", conn_index, frag.id, r->next_index, r->length);
+        process_received_message(conn_index, r->data, (int)r->length);
+        finish_reassembly(r);
+    }
+}
+
+// 处理已经由内核写入外部缓冲（io_uring 提供缓冲）的接收数据
+// 连接接收缓冲为空时直接在外部缓冲上解析，只把末尾不完整的电文拷入接收缓冲；
+// 否则先追加到接收缓冲再解析。电文头长度异常时返回 false
+bool feed_received_bytes(int conn_index, const char* data, int length) {
+    ReceiveBuffer* rb = &receive_buffers[conn_index];
+    if (rb->readable() == 0) {
+        int consumed = parse_frames(conn_index, data, length);
+        if (consumed < 0) return false;
+        data += consumed;
+        length -= consumed;
+        if (length == 0) return true;
     }
+    rb->reserve(length);
+    memcpy(rb->write_ptr(), data, length);
+    rb->commit(length);
+    int consumed = parse_frames(conn_index, rb->read_ptr(), rb->readable());
+    if (consumed < 0) return false;
+    rb->consume(consumed);
+    return true;
 }
 
 // 处理连接断开
@@ -395,78 +923,256 @@ bool connect_to_server(int conn_index) {
         return false; // 检查 as_server 项，避免非预期的调用
     }
 
-    int sock = create_client_socket(g_connections[conn_index].ip, g_connections[conn_index].port);
+    bool in_progress = false;
+    int sock = create_client_socket(g_connections[conn_index].ip, g_connections[conn_index].port, &in_progress);
     if (sock < 0) {
         return false;
     }
 
     pthread_mutex_lock(&connections_mutex);
-    g_connections[conn_index].socket = sock;
-
-    // 加入 epoll
-    struct epoll_event ev;
-    ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
-    ev.data.fd = sock;
-    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sock, &ev);
-
     // 初始化接收缓冲
     // 每次重连也会重置接收缓冲
-    memset(&receive_buffers[conn_index], 0, sizeof(ReceiveBuffer));
+    receive_buffers[conn_index].reset();
+    reset_reassembly(conn_index);
+
+    g_connections[conn_index].socket = sock;
+    conn_generations[conn_index]++;
+    pthread_mutex_lock(&send_mutexes[conn_index]);
+    conn_connecting[conn_index] = in_progress;
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
+
+    // 交给负载最小的反应器，连接是否成功由反应器判断
+    attach_to_reactor(conn_index);
 
-    LOGI("已连接到 %s:%d",
-           g_connections[conn_index].ip, g_connections[conn_index].port);
+    LOGI("%s %s:%d，由反应器 %d 处理", in_progress ? "正在连接" : "已连接到",
+           g_connections[conn_index].ip, g_connections[conn_index].port, conn_reactors[conn_index].load());
     pthread_mutex_unlock(&connections_mutex);
 
     return true;
 }
 
-// 为数据加上电文头，组装成完整电文后，发送到缓冲链，调用时需持有 connections_mutex 锁
-void add_to_send_buffer(int conn_index, const char* data, int length) {
-    int head_len = MsgHead::get_head_length();
-    SendBuffer* new_buffer = (SendBuffer*)malloc(sizeof(SendBuffer));
-    new_buffer->total_length = length + head_len; // 此长度包含电文头
-    new_buffer->data = (char*)malloc(new_buffer->total_length);
+// 非阻塞连接有了结果（套接字可写或出错）时由所属反应器调用，通过 SO_ERROR 判断连接是否成功
+// 成功返回 true；失败时释放连接，等待连接管理线程重连，返回 false
+bool finish_connect(int conn_index) {
+    int sock = g_connections[conn_index].socket;
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
+        err = errno;
+    }
+    if (err != 0) {
+        LOGE("连接到 %s:%d 失败: (%d) %s",
+             g_connections[conn_index].ip, g_connections[conn_index].port, err, strerror(err));
+        cleanup_connection(conn_index, false);
+        return false;
+    }
+
+    pthread_mutex_lock(&send_mutexes[conn_index]);
+    conn_connecting[conn_index] = false;
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
+    LOGI("已连接到 %s:%d", g_connections[conn_index].ip, g_connections[conn_index].port);
+    return true;
+}
+
+// 从内存池分配的电文体的释放函数
+static void release_pool_body(char* data, void* ctx) {
+    (void)ctx;
+    pool_free(data);
+}
+
+// 释放消息持有的电文体
+static inline void release_message(const Message& msg) {
+    if (msg.release != NULL) {
+        msg.release(msg.data, msg.release_ctx);
+    }
+}
+
+// 释放缓冲链节点及其电文体
+static void free_send_buffer(SendBuffer* buffer) {
+    if (buffer->release != NULL) {
+        buffer->release(buffer->body, buffer->release_ctx);
+    }
+    pool_free(buffer);
+}
+
+// 按连接配置的 DC 生成连接的电文头模板，未配置的字段使用默认值
+static void build_head_template(int conn_index) {
+    const Commloop& conn = g_connections[conn_index];
+    WireHead::init_template(&conn_head_templates[conn_index], DEFAULT_MSGID,
+                            conn.senddc[0] != '\0' ? conn.senddc : DEFAULT_SENDDC,
+                            conn.recvdc[0] != '\0' ? conn.recvdc : DEFAULT_RECVDC);
+}
+
+// 校验调用方指定的电文号并拷贝到消息中：须为 4 个字符，不能含有空格或串结束符
+// msgid 为 NULL 时消息使用连接模板中的默认电文号
+static bool copy_msgid(char* out, const char* msgid) {
+    if (msgid == NULL) {
+        out[0] = '\0';
+        return true;
+    }
+    for (size_t i = 0; i < sizeof(MsgHead::msgid); i++) {
+        if (msgid[i] == '\0' || msgid[i] == ' ') {
+            LOGW("电文号非法：%.4s", msgid);
+            return false;
+        }
+    }
+    memcpy(out, msgid, sizeof(MsgHead::msgid));
+    return true;
+}
+
+// 分隔符模式下电文体中不能出现分隔符，否则接收方会在该处截断电文；其他格式总是返回 true
+static bool body_fits_delimited(const char* data, size_t length) {
+    if constexpr (WireHead::delimited) {
+        if (scan_byte(data, length, WireHead::delimiter) != NULL) {
+            LOGW("电文体中含有分隔符 0x%02x，分隔符模式下无法发送", (unsigned char)WireHead::delimiter);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 计算长度为 length 的电文体拆分的段数写入 *chunks；需要拆分且电文头能标记分片时分配分片消息号写入 *frag_id，
+// 否则 *frag_id 为 -1，各段作为互相独立的电文发送。段数超过电文头能表示的分片数时返回 false
+static bool plan_fragments(size_t length, int* chunks, int* frag_id) {
+    size_t count = (length + MAX_MESSAGE_BODY_SIZE - 1) / MAX_MESSAGE_BODY_SIZE;
+    *frag_id = -1;
+    if (count > 1 && WireHead::supports_fragments) {
+        if (count > (size_t)WireHead::max_fragments) {
+            LOGW("消息体 %zu 字节需拆分为 %zu 个分片，超过上限 %d 个", length, count, WireHead::max_fragments);
+            return false;
+        }
+        *frag_id = (int)(next_fragment_id.fetch_add(1, std::memory_order_relaxed) % WireHead::fragment_ids);
+    }
+    *chunks = (int)count;
+    return true;
+}
+
+// 把拆分后的第 index 段（共 chunks 段）标记为分片消息 frag_id 的分片，frag_id 为 -1 时不标记
+static inline void mark_fragment(Message* msg, int frag_id, int index, int chunks) {
+    msg->flags &= ~(MSG_FLAG_FRAGMENT | MSG_FLAG_LAST_FRAGMENT);
+    if (frag_id < 0) return;
+    msg->flags |= MSG_FLAG_FRAGMENT | (index == chunks - 1 ? MSG_FLAG_LAST_FRAGMENT : 0);
+    msg->frag_id = (unsigned short)frag_id;
+    msg->frag_index = (unsigned short)index;
+}
+
+// 为消息生成电文头，连同消息的电文体一起加到缓冲链，调用时需持有 send_mutexes[conn_index] 锁
+// 电文头由连接的模板拷贝而来，由 WireHead::stamp() 改写长度等逐条变化的字段（默认格式为电文号、长度、日期时间与序列号）；
+// 序列号在这里（而不是各生产者入队时）分配，多个生产者共用一个连接时序列号的顺序也与写入套接字的顺序一致
+// 电文体的所有权随之移交给缓冲链节点，不做拷贝；已成帧的消息不生成电文头，原样发送
+void add_to_send_buffer(int conn_index, const Message& msg) {
+    SendBuffer* new_buffer = (SendBuffer*)pool_alloc(sizeof(SendBuffer));
+    if (msg.flags & MSG_FLAG_FRAMED) {
+        new_buffer->head_length = 0;
+        new_buffer->tail_length = 0;
+    } else {
+        new_buffer->head = conn_head_templates[conn_index];
+        WireHead::stamp(&new_buffer->head, msg.msgid[0] != '\0' ? msg.msgid : NULL, msg.length,
+                        ++conn_send_seqnos[conn_index]);
+        if (msg.flags & MSG_FLAG_FRAGMENT) {
+            FragmentInfo frag = {msg.frag_id, msg.frag_index, (msg.flags & MSG_FLAG_LAST_FRAGMENT) != 0};
+            WireHead::stamp_fragment(&new_buffer->head, frag);
+        }
+        new_buffer->head_length = WireHead::head_length;
+        new_buffer->tail_length = WireHead::terminator_length;
+    }
+    new_buffer->body = msg.data;
+    new_buffer->body_length = msg.length;
+    new_buffer->total_length = new_buffer->head_length + msg.length + new_buffer->tail_length; // 此长度包含电文头与结束符
     new_buffer->sent_bytes = 0;
+    new_buffer->release = msg.release;
+    new_buffer->release_ctx = msg.release_ctx;
     new_buffer->next = NULL;
 
-    // 生成电文头，组装成完整电文
-    MsgHead msg_head = {};
-    msg_head.random_fill(length);
-    memcpy(new_buffer->data, &msg_head, head_len);
-    memcpy(new_buffer->data + head_len, data, length);
+    append_send_buffer(&send_buffers[conn_index], &send_buffer_tails[conn_index], new_buffer);
+}
 
-    // 加到缓冲链末尾
-    if (send_buffers[conn_index] == NULL) {
-        send_buffers[conn_index] = new_buffer;
-    } else {
-        SendBuffer* current = send_buffers[conn_index];
-        while (current->next != NULL) {
-            current = current->next;
+// 从缓冲链头部起为未发送的数据填写 iovec，每个节点的电文头、电文体与结束符各占一个，
+// 至多 max_iov 个 iovec 或 SEND_GATHER_BYTES 字节
+// 返回填写的 iovec 数，*total 为其字节总数，*nodes 为涉及的节点数；调用时需持有 send_mutexes[conn_index] 锁
+static int gather_send_iov(int conn_index, struct iovec* iov, int max_iov, size_t* total, int* nodes) {
+    int count = 0;
+    *total = 0;
+    *nodes = 0;
+    for (SendBuffer* b = send_buffers[conn_index]; b != NULL && count + 3 <= max_iov; b = b->next) {
+        (*nodes)++;
+        if (b->sent_bytes < b->head_length) {
+            iov[count].iov_base = (char*)&b->head + b->sent_bytes;
+            iov[count].iov_len = b->head_length - b->sent_bytes;
+            *total += iov[count].iov_len;
+            count++;
+        }
+        int body_sent = std::max(b->sent_bytes - b->head_length, 0);
+        if (b->body_length > body_sent) {
+            iov[count].iov_base = b->body + body_sent;
+            iov[count].iov_len = b->body_length - body_sent;
+            *total += iov[count].iov_len;
+            count++;
+        }
+        int tail_sent = std::max(b->sent_bytes - b->head_length - b->body_length, 0);
+        if (b->tail_length > tail_sent) {
+            iov[count].iov_base = (char*)WireHead::terminator() + tail_sent;
+            iov[count].iov_len = b->tail_length - tail_sent;
+            *total += iov[count].iov_len;
+            count++;
         }
-        current->next = new_buffer;
+        if (*total >= SEND_GATHER_BYTES) break;
     }
+    return count;
 }
 
-// 尝试发送缓冲链中的数据，调用时需持有 connections_mutex 锁
+// 从缓冲链头部起确认 sent 字节已发送，释放全部发完的节点；短写可能停在任意节点的中间
+// 调用时需持有 send_mutexes[conn_index] 锁
+static void consume_sent_bytes(int conn_index, size_t sent) {
+    size_t freed_bytes = 0;
+    size_t freed_msgs = 0;
+    while (sent > 0 && send_buffers[conn_index] != NULL) {
+        SendBuffer* buffer = send_buffers[conn_index];
+        size_t remaining = buffer->total_length - buffer->sent_bytes;
+        if (sent < remaining) {
+            buffer->sent_bytes += (int)sent;
+            break;
+        }
+        sent -= remaining;
+        send_buffers[conn_index] = buffer->next;
+        if (buffer->next == NULL) {
+            send_buffer_tails[conn_index] = NULL;
+        }
+        freed_bytes += buffer->total_length;
+        freed_msgs++;
+        free_send_buffer(buffer);
+    }
+    if (freed_msgs > 0) {
+        release_send_space(conn_index, freed_bytes, freed_msgs);
+    }
+}
+
+// 尝试发送缓冲链中的数据，调用时需持有 send_mutexes[conn_index] 锁
+// 每次以一个 sendmsg 聚合发送多个节点，减少小电文的系统调用次数
 bool send_buffered_data(int conn_index) {
     int sock = g_connections[conn_index].socket;
     if (sock == -1) return false;
+    if (conn_connecting[conn_index]) return true;   // 连接完成后再发送
 
+    struct iovec iov[SEND_GATHER_MAX_IOV];
     while (send_buffers[conn_index] != NULL) {
-        // 拷贝当前缓冲
-        SendBuffer* buffer = send_buffers[conn_index];
-        // 计算剩余的未发送字符，并发送这些字符
-        int remaining = buffer->total_length - buffer->sent_bytes;
-        int sent = send(sock, buffer->data + buffer->sent_bytes, remaining, MSG_NOSIGNAL);
+        size_t total;
+        int nodes;
+        int count = gather_send_iov(conn_index, iov, SEND_GATHER_MAX_IOV, &total, &nodes);
+        struct msghdr msg = {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t sent = sendmsg(sock, &msg, MSG_NOSIGNAL);
 
         if (sent > 0) {
-            LOGI("尝试发送连接 %d 的缓冲数据 %d 字节，实际发送 %d 字节；前 %d 字节：%s (%s)",
-                 conn_index, remaining, sent, (int)std::min<size_t>(sent, 128),
-                 HEX_DUMP(buffer->data + buffer->sent_bytes, sent),
-                 ASCII_DUMP(buffer->data + buffer->sent_bytes, sent));
+            int first = (int)std::min<size_t>(sent, iov[0].iov_len);
+            LOGI("尝试发送连接 %d 的缓冲数据 %zu 字节（%d 个节点），实际发送 %zd 字节；前 %d 字节：%s (%s)",
+                 conn_index, total, count, sent, std::min(first, 128),
+                 HEX_DUMP((const char*)iov[0].iov_base, first),
+                 ASCII_DUMP((const char*)iov[0].iov_base, first));
         } else {
-            LOGI("尝试发送连接 %d 的缓冲数据 %d 字节，实际发送 %d 字节（失败或无数据）",
-                 conn_index, remaining, sent);
+            LOGI("尝试发送连接 %d 的缓冲数据 %zu 字节（%d 个节点），实际发送 %zd 字节（失败或无数据）",
+                 conn_index, total, count, sent);
         }
 
         if (sent <= 0) {
@@ -476,20 +1182,34 @@ bool send_buffered_data(int conn_index) {
                 return false;   // 发生其他错误
             }
         }
-        // 更新已发送字节数            
-        buffer->sent_bytes += sent;
-
-        // 如果当前缓冲已全部发送，释放该节点
-        if (buffer->sent_bytes >= buffer->total_length) {
-            send_buffers[conn_index] = buffer->next;
-            free(buffer->data);
-            free(buffer);
+        consume_sent_bytes(conn_index, (size_t)sent);
+        // 短写说明内核发送缓冲已满，等待 EPOLLOUT 再继续
+        if ((size_t)sent < total) {
+            return true;
         }
     }
 
     return true;
 }
 
+// 打印发送路径内存池的统计
+static void log_pool_stats() {
+    PoolClassStats stats[POOL_CLASS_COUNT];
+    uint64_t large_allocs, large_frees;
+    pool_get_stats(stats, &large_allocs, &large_frees);
+    for (int c = 0; c < POOL_CLASS_COUNT; c++) {
+        if (stats[c].allocs == 0 && stats[c].reserved_blocks == 0) continue;
+        LOGI("内存池 %5zu 字节级：分配 %llu 次，释放 %llu 次，向系统申请 %llu 块，仓库空闲 %llu 块，批量转移 %llu 次",
+             stats[c].block_size, (unsigned long long)stats[c].allocs, (unsigned long long)stats[c].frees,
+             (unsigned long long)stats[c].reserved_blocks, (unsigned long long)stats[c].depot_blocks,
+             (unsigned long long)stats[c].depot_transfers);
+    }
+    if (large_allocs > 0) {
+        LOGI("内存池之外直接分配 %llu 次，释放 %llu 次",
+             (unsigned long long)large_allocs, (unsigned long long)large_frees);
+    }
+}
+
 // 处理收到的消息，已由上层函数去除电文头
 void process_received_message(int conn_index, const char* data, int length) {
     LOGI("来自连接 %d 的电文接收完成，电文体总长度 = %d，前 %d 字节：%s (%s)",
@@ -499,18 +1219,32 @@ void process_received_message(int conn_index, const char* data, int length) {
     // 在此加入业务处理逻辑
     // ======================
     // 将收到的消息回显给发送方，用于测试
-    add_to_send_queue_std_string(conn_index, std::string(data, length));
+    // 电文体仍在接收缓冲中，拷贝到内存池分配的块后移交，发送完毕由反应器归还内存池
+    char* body = (char*)pool_alloc(length);
+    if (body == NULL) {
+        LOGE("内存分配失败 length=%d", length);
+        return;
+    }
+    memcpy(body, data, length);
+    add_to_send_queue_buffer(conn_index, body, length, release_pool_body, NULL);
 }
 
 // 清理连接
 // 从 epoll 移除、关闭、清空缓冲
 // 参数 try_flush 指示是否在关闭前尝试发送遗留的 send_buffers[conn_index]
 void cleanup_connection(int conn_index, bool try_flush = false) {
+    bool reconnect = false;
+    bool connect_failed = false;
     pthread_mutex_lock(&connections_mutex);
+    pthread_mutex_lock(&send_mutexes[conn_index]);
 
     if (g_connections[conn_index].socket != -1) {
+        reconnect = running && g_connections[conn_index].as_server == 0;
+        connect_failed = conn_connecting[conn_index];
         // 关闭前尽量刷新发送缓冲
         if (try_flush && send_buffers[conn_index] != NULL) {
+            // io_uring 后端下套接字为阻塞模式，刷新前改回非阻塞，避免对端不读时卡住退出流程
+            set_nonblocking(g_connections[conn_index].socket);
             int attempts = 0;
             while (attempts < 3 && send_buffers[conn_index] != NULL) {
                 bool ok = send_buffered_data(conn_index);
@@ -520,147 +1254,1443 @@ void cleanup_connection(int conn_index, bool try_flush = false) {
             LOGI("cleanup 前刷新连接 %d 的发送缓冲，尝试 %d 次，剩余: %s",
                  conn_index, attempts, send_buffers[conn_index] ? "未清空" : "已清空");
         }
-        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, g_connections[conn_index].socket, NULL);
+        detach_from_reactor(conn_index);
         close(g_connections[conn_index].socket);
         g_connections[conn_index].socket = -1;
+        conn_generations[conn_index]++;
+        conn_connecting[conn_index] = false;
     }
 
     // 清空发送缓冲
+    size_t freed_bytes = 0;
+    size_t freed_msgs = 0;
     while (send_buffers[conn_index] != NULL) {
         SendBuffer* buffer = send_buffers[conn_index];
         send_buffers[conn_index] = buffer->next;
-        free(buffer->data);
-        free(buffer);
+        freed_bytes += buffer->total_length;
+        freed_msgs++;
+        free_send_buffer(buffer);
+    }
+    send_buffer_tails[conn_index] = NULL;
+    send_pinned_nodes[conn_index] = 0;
+    if (freed_msgs > 0) {
+        release_send_space(conn_index, freed_bytes, freed_msgs);
     }
+    // 套接字已关闭，发送队列中尚未组装的消息随之释放并归还额度
+    drain_conn_send_queue(conn_index);
+    // 清除登记标记，重连后的第一条消息重新登记；ready 队列中残留的旧登记被取出时只是取到空队列
+    conn_send_scheduled[conn_index].store(false, std::memory_order_release);
 
     // 清空接收缓冲
-    memset(&receive_buffers[conn_index], 0, sizeof(ReceiveBuffer));
+    receive_buffers[conn_index].reset();
+    reset_reassembly(conn_index);
 
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
     pthread_mutex_unlock(&connections_mutex);
+
+    // 主动连接断开或连接失败后由主线程按退避时间安排重连
+    if (reconnect) {
+        request_reconnect(conn_index, connect_failed);
+    }
 }
 
-// 连接管理线程，用于负责主动连接的重连
-void* connection_manager_thread(void* arg) {
-    while (running) {
-        // 等价于 sleep(RECONNECT_INTERVAL);
-        my_sleep_seconds(RECONNECT_INTERVAL);
+// 反应器线程，等待并处理分配到本反应器的连接上的事件
+// 反应器线程绑定到各自的 CPU，连接按负载分散到各个反应器上
+void* reactor_thread(void* arg) {
+    Reactor* reactor = (Reactor*)arg;
+    tls_reactor = reactor;
+
+    int ncpu = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu > 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(reactor->id % ncpu, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
 
-        for (int i = 0; i < g_connections_len; i++) {
-            // 只在检查状态时加锁，防止与 connect_to_server 的内部加锁发生死锁
-            pthread_mutex_lock(&connections_mutex);
-            bool need_reconnect = g_connections[i].as_server == 0 && g_connections[i].socket == -1;
-            pthread_mutex_unlock(&connections_mutex);
-            if (need_reconnect) {
-                LOGI("尝试重连到 %s:%d",
-                     g_connections[i].ip, g_connections[i].port);
-                connect_to_server(i);
-            }
-        }
+    LOGD("反应器 %d 已启动", reactor->id);
+    if (g_io_backend == IO_URING) {
+        reactor_loop_uring(reactor);
+    } else {
+        reactor_loop_epoll(reactor);
     }
     return NULL;
 }
-// 发送线程，从发送队列取数据并发送
-void* send_thread(void* arg) {
+
+// epoll 后端的反应器事件循环
+static void reactor_loop_epoll(Reactor* reactor) {
+    struct epoll_event events[MAX_EVENTS];
+
     while (running) {
-        pthread_mutex_lock(&send_queue_mutex);
-        // 队列空则等待
-        while (send_queue.empty() && running) {
-            // 释放锁并等待条件变量
-            pthread_cond_wait(&send_queue_cv, &send_queue_mutex);
-        }
-        if (!running) { // 退出
-            pthread_mutex_unlock(&send_queue_mutex);
+        // 收集在 epoll 监控的事件中已经发生的事件，如果 epoll 中没有任何一个事件发生，则最多等待 1000ms
+        int nfds = epoll_wait(reactor->epoll_fd, events, MAX_EVENTS, 1000);
+
+        if (nfds < 0) {
+            if (errno == EINTR) continue;
+            LOG_SYSERR("epoll_wait");
             break;
         }
-        Message msg = send_queue.front();
-        send_queue.pop();
-        pthread_mutex_unlock(&send_queue_mutex);
 
-        // 此处对 g_connections 数组对应的缓冲进行加锁
-        pthread_mutex_lock(&connections_mutex);
-        
-        if (g_connections[msg.target_index].socket != -1) {
-            // 将发送数据加入对应连接的发送缓冲
-            add_to_send_buffer(msg.target_index, msg.data, msg.length);
-            // 立即尝试一次发送
-            send_buffered_data(msg.target_index);
+        for (int i = 0; i < nfds; i++) {
+            if (events[i].data.u64 == REACTOR_WAKE_TOKEN) {
+                // 有连接登记了待发送的消息
+                uint64_t value;
+                while (read(reactor->wake_fd, &value, sizeof(value)) > 0) {}
+                drain_ready_queue(reactor);
+                continue;
+            }
+            handle_connection_event(events[i].data.u64, events[i].events);
         }
-        pthread_mutex_unlock(&connections_mutex);
-
-        free(msg.data);
     }
-    return NULL;
 }
 
-// 获取待发送电文线程
-// 
-// 一般来讲，此项目仅用于电文的收发，待发送电文是从别的进程获取的。 
-// 整个电文（含电文头）应该由业务进程组装，本项目仅负责发送数据。
-// 未来可在此处阻塞/轮询业务模块或读取文件/消息队列以获取要发送的电文。
-void* get_sendmsg_thread(void* arg) {
-    while (running) {
-        // 占位：模拟周期性检查外部来源是否有新电文
-        // 在这里未来可以添加：
-        // 1. 读取文件 / 命名管道 / 消息队列
-        // 2. 从共享内存或业务模块获取待发送消息
-        // 3. 解析并加入到对应的 send_buffer
-        LOGD("get_sendmsg_thread 周期检查，占位实现");
-        // 等价于 sleep(1)
-        my_sleep_seconds(1);
+// 处理已有连接上的一次 epoll 事件，在连接所属的反应器线程中调用
+void handle_connection_event(uint64_t token, uint32_t events) {
+    // 由句柄直接得到连接下标
+    int conn_index = resolve_conn_token(token);
+    if (conn_index == -1) {
+        LOGD("丢弃已失效连接的 epoll 事件，句柄 %016llx", (unsigned long long)token);
+        return;
+    }
+    // 非阻塞连接尚未完成时，可写或出错事件表示连接有了结果
+    if (conn_connecting[conn_index]) {
+        if (!(events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) return;
+        if (!finish_connect(conn_index)) return;
+    }
+    // 表示对应的文件描述符可以读（包括对端SOCKET正常关闭）
+    if (events & EPOLLIN) {
+        LOGD("EPOLL 发现连接 %d 有数据可读，尝试读取数据", conn_index);
+        handle_client_data(conn_index);
+    }
+    // 读取过程中连接可能已经断开，此后的事件不再属于当前连接
+    if (resolve_conn_token(token) == -1) {
+        return;
+    }
+    // 表示对应的文件描述符可以写，此时尝试发送缓冲区的数据
+    if (events & EPOLLOUT) {
+        LOGD("EPOLL 发现连接 %d 可写，尝试发送缓冲区数据", conn_index);
+        pthread_mutex_lock(&send_mutexes[conn_index]);
+        bool success = send_buffered_data(conn_index);
+        pthread_mutex_unlock(&send_mutexes[conn_index]);
+        if (!success) {
+            handle_client_disconnect(conn_index);
+            return;
+        }
+    }
+    // 连接关闭或错误
+    if (events & (EPOLLHUP | EPOLLERR)) {
+        handle_client_disconnect(conn_index);
     }
-    return NULL;
 }
 
-// 将数据加入到发送队列，使用 std::string 作为输入
-// 如果数据长度超过 MAX_MESSAGE_BODY_SIZE ，则拆分为多段发送
-bool add_to_send_queue_std_string(int conn_index, const std::string& data) {
-    if (conn_index < 0 || conn_index >= g_connections_len) {
-        LOGW("参数非法 conn_index=%d", conn_index);
+// ================ io_uring 后端 =================
+// 每个反应器拥有一个 io_uring 实例：
+// - 每个连接一个多发 recv，内核从反应器的提供缓冲环中挑选缓冲写入数据，一次提交持续产生完成事件
+// - 待发送的缓冲链节点聚合为一个 sendmsg 提交，每个连接同一时刻至多一个在途，
+//   带 MSG_WAITALL 使内核在短写时自行续发
+// - 其他线程通过 eventfd（多发 poll）唤醒反应器，登记新连接或待发送的连接
+// 监听套接字由主线程的 io_uring 实例以多发 accept 接受连接。
+
+// io_uring 的 user_data：高 32 位为插槽代数，低 24 位为插槽下标，中间 8 位为请求类型
+static inline uint64_t make_uring_data(UringOp op, int conn_index) {
+    uint64_t token = conn_index < 0 ? 0 : make_conn_token(conn_index);
+    return (token & 0xFFFFFFFF00FFFFFFULL) | ((uint64_t)op << 24);
+}
+
+static inline UringOp uring_data_op(uint64_t data) {
+    return (UringOp)((data >> 24) & 0xFF);
+}
+
+static inline int resolve_uring_data(uint64_t data) {
+    return resolve_conn_token(data & 0xFFFFFFFF00FFFFFFULL);
+}
+
+// 为反应器创建 io_uring 实例与提供缓冲环，内核不支持时返回 false
+static bool init_uring_reactor(Reactor* reactor) {
+    int ret = reactor->ring.init(URING_ENTRIES);
+    if (ret < 0) {
+        LOGW("反应器 %d 创建 io_uring 失败: (%d) %s", reactor->id, -ret, strerror(-ret));
         return false;
     }
-    if (data.empty()) {
-        LOGW("数据为空 conn_index=%d", conn_index);
+    ret = reactor->bufs.init(reactor->ring, 0, URING_BUF_COUNT, URING_BUF_SIZE);
+    if (ret < 0) {
+        LOGW("反应器 %d 注册提供缓冲环失败: (%d) %s", reactor->id, -ret, strerror(-ret));
+        reactor->ring.destroy();
         return false;
     }
+    pthread_mutex_init(&reactor->pending_mutex, NULL);
+    return true;
+}
 
-    size_t total = data.size();
-    size_t offset = 0;
-    int chunks = 0;
+// 释放反应器的 io_uring 资源，须先关闭 ring 再释放提供缓冲
+static void destroy_uring_reactor(Reactor* reactor) {
+    reactor->ring.destroy();
+    reactor->bufs.destroy();
+    pthread_mutex_destroy(&reactor->pending_mutex);
+}
 
-    // 再持锁的状态下将数据拆分并加入发送队列, 然后通过条件变量唤醒发送线程
-    pthread_mutex_lock(&send_queue_mutex);
-    while (offset < total) {
-        size_t chunk_len = std::min(static_cast<size_t>(MAX_MESSAGE_BODY_SIZE),
-                                    total - offset);
+// 唤醒反应器，处理待处理列表与 ready 队列
+static void wake_reactor(Reactor* reactor) {
+    uint64_t one = 1;
+    if (write(reactor->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        LOG_SYSERR("write eventfd");
+    }
+}
 
-        Message msg;
-        msg.length = static_cast<int>(chunk_len);
-        msg.target_index = conn_index;
-        msg.data = (char*)malloc(chunk_len);
-        if (!msg.data) {
-            LOGE("内存分配失败 chunk_len=%zu", chunk_len);
-            // 已经排入队列的数据保持；退出
-            pthread_mutex_unlock(&send_queue_mutex);
-            return false;
-        }
-        memcpy(msg.data, data.data() + offset, chunk_len);
-        send_queue.push(msg);
+// 请求连接所属的反应器提交发送缓冲链中的数据，调用时需持有 send_mutexes[conn_index] 锁
+static void request_flush(int conn_index) {
+    int r = conn_reactors[conn_index];
+    if (r < 0) return;  // 尚未交给反应器，反应器接手连接时会发送已缓冲的数据
+    pthread_mutex_lock(&reactors[r].pending_mutex);
+    reactors[r].pending_flush.push_back(conn_index);
+    pthread_mutex_unlock(&reactors[r].pending_mutex);
+    wake_reactor(&reactors[r]);
+}
 
-        offset += chunk_len;
-        ++chunks;
+// 在连接上提交多发 recv
+static void uring_arm_recv(Reactor* reactor, int conn_index) {
+    struct io_uring_sqe* sqe = reactor->ring.get_sqe();
+    if (sqe == NULL) {
+        LOGE("反应器 %d 提交队列已满，无法在连接 %d 上接收", reactor->id, conn_index);
+        uring_begin_close(conn_index);
+        return;
     }
-    // 入队完成，唤醒发送线程
-    pthread_cond_signal(&send_queue_cv);
-    pthread_mutex_unlock(&send_queue_mutex);
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = g_connections[conn_index].socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = reactor->bufs.bgid;
+    sqe->user_data = make_uring_data(UOP_RECV, conn_index);
+    uring_conns[conn_index].ops++;
+}
 
-    LOGI("已将消息加入发送队列，目标连接 %d，消息体总长度 %zu 字节，共分 %d 段；前 %d 字节：%s (%s)",
-         conn_index, total, chunks,
-         (int)std::min<size_t>(total, 128),
+// 在正在连接的套接字上提交一次 POLLOUT 的 poll，用于获知非阻塞连接的结果
+static void uring_arm_connect_poll(Reactor* reactor, int conn_index) {
+    struct io_uring_sqe* sqe = reactor->ring.get_sqe();
+    if (sqe == NULL) {
+        LOGE("反应器 %d 提交队列已满，无法等待连接 %d 完成", reactor->id, conn_index);
+        uring_begin_close(conn_index);
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = g_connections[conn_index].socket;
+    sqe->poll32_events = POLLOUT;
+    sqe->user_data = make_uring_data(UOP_CONNECT, conn_index);
+    uring_conns[conn_index].ops++;
+}
+
+// 把连接发送缓冲链中的节点聚合为一个 sendmsg 提交，同一时刻每个连接至多一个在途
+static void uring_flush(Reactor* reactor, int conn_index) {
+    UringConnState* st = &uring_conns[conn_index];
+    if (st->closing || st->sending) return;     // 在途的 sendmsg 结束后会再次调用
+    if (conn_connecting[conn_index]) return;    // 连接完成后再发送
+
+    pthread_mutex_lock(&send_mutexes[conn_index]);
+    size_t total;
+    int nodes;
+    int count = gather_send_iov(conn_index, st->send_iov, URING_SEND_MAX_IOV, &total, &nodes);
+    // 提交失败时连接随即关闭，不会再丢弃节点
+    send_pinned_nodes[conn_index] = nodes;
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
+    if (count == 0) return;
+
+    struct io_uring_sqe* sqe = reactor->ring.get_sqe();
+    if (sqe == NULL) {
+        LOGE("反应器 %d 提交队列已满，无法在连接 %d 上发送", reactor->id, conn_index);
+        uring_begin_close(conn_index);
+        return;
+    }
+    memset(&st->send_msg, 0, sizeof(st->send_msg));
+    st->send_msg.msg_iov = st->send_iov;
+    st->send_msg.msg_iovlen = count;
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = g_connections[conn_index].socket;
+    sqe->addr = (uint64_t)(uintptr_t)&st->send_msg;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    sqe->user_data = make_uring_data(UOP_SEND, conn_index);
+    st->sending = true;
+    st->ops++;
+}
+
+// 开始关闭连接：关闭套接字的读写使在途请求尽快结束，全部结束后才释放连接
+static void uring_begin_close(int conn_index) {
+    UringConnState* st = &uring_conns[conn_index];
+    if (!st->closing) {
+        st->closing = true;
+        shutdown(g_connections[conn_index].socket, SHUT_RDWR);
+    }
+    if (st->ops == 0) {
+        st->closing = false;
+        handle_client_disconnect(conn_index);
+    }
+}
+
+// 处理唤醒事件：接手新连接，提交有新数据的连接的 sendmsg，发送登记到 ready 队列的连接
+static void uring_on_wake(Reactor* reactor) {
+    uint64_t value;
+    while (read(reactor->wake_fd, &value, sizeof(value)) > 0) {}
+
+    std::vector<int> attach, flush;
+    pthread_mutex_lock(&reactor->pending_mutex);
+    attach.swap(reactor->pending_attach);
+    flush.swap(reactor->pending_flush);
+    pthread_mutex_unlock(&reactor->pending_mutex);
+
+    for (int conn_index : attach) {
+        uring_conns[conn_index] = UringConnState();
+        if (conn_connecting[conn_index]) {
+            uring_arm_connect_poll(reactor, conn_index);
+        } else {
+            uring_arm_recv(reactor, conn_index);
+            uring_flush(reactor, conn_index);
+        }
+    }
+    for (int conn_index : flush) {
+        if (conn_reactors[conn_index] == reactor->id && g_connections[conn_index].socket != -1) {
+            uring_flush(reactor, conn_index);
+        }
+    }
+    drain_ready_queue(reactor);
+}
+
+// 处理多发 recv 的完成事件
+static void uring_on_recv(Reactor* reactor, const struct io_uring_cqe* cqe) {
+    int conn_index = resolve_uring_data(cqe->user_data);
+    bool has_buffer = cqe->flags & IORING_CQE_F_BUFFER;
+    uint16_t bid = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+    if (conn_index == -1) {
+        LOGW("丢弃已失效连接的 recv 完成事件");
+        if (has_buffer) reactor->bufs.recycle(bid);
+        return;
+    }
+    UringConnState* st = &uring_conns[conn_index];
+
+    if (has_buffer) {
+        if (cqe->res > 0 && !st->closing && running) {
+            LOGD("从连接 %d 读取 %d 字节", conn_index, cqe->res);
+            if (!feed_received_bytes(conn_index, reactor->bufs.buffer(bid), cqe->res)) {
+                // 由于发送方发送的电文出错，导致长度异常，作断开连接处理
+                uring_begin_close(conn_index);
+            }
+        }
+        reactor->bufs.recycle(bid);
+    }
+
+    if (cqe->flags & IORING_CQE_F_MORE) return;
+
+    // 多发 recv 已结束
+    st->ops--;
+    if (st->closing || !running) {
+        if (st->closing) uring_begin_close(conn_index);
+    } else if (cqe->res > 0 || cqe->res == -ENOBUFS) {
+        // 完成队列溢出或提供缓冲暂时用尽，重新提交
+        uring_arm_recv(reactor, conn_index);
+    } else {
+        // 对端关闭（res == 0）或出错
+        if (cqe->res < 0) {
+            LOGW("连接 %d 接收出错: (%d) %s", conn_index, -cqe->res, strerror(-cqe->res));
+        }
+        uring_begin_close(conn_index);
+    }
+}
+
+// 处理非阻塞连接结果的 poll 完成事件
+static void uring_on_connect(Reactor* reactor, const struct io_uring_cqe* cqe) {
+    int conn_index = resolve_uring_data(cqe->user_data);
+    if (conn_index == -1) {
+        LOGW("丢弃已失效连接的 connect 完成事件");
+        return;
+    }
+    UringConnState* st = &uring_conns[conn_index];
+    st->ops--;
+    if (st->closing || !running) {
+        if (st->closing) uring_begin_close(conn_index);
+        return;
+    }
+    if (finish_connect(conn_index)) {
+        uring_arm_recv(reactor, conn_index);
+        uring_flush(reactor, conn_index);
+    }
+}
+
+// 处理 sendmsg 的完成事件
+static void uring_on_send(Reactor* reactor, const struct io_uring_cqe* cqe) {
+    int conn_index = resolve_uring_data(cqe->user_data);
+    if (conn_index == -1) {
+        LOGW("丢弃已失效连接的 send 完成事件");
+        return;
+    }
+    UringConnState* st = &uring_conns[conn_index];
+    st->ops--;
+    st->sending = false;
+
+    pthread_mutex_lock(&send_mutexes[conn_index]);
+    send_pinned_nodes[conn_index] = 0;
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
+    if (cqe->res > 0) {
+        const struct iovec* first = &st->send_iov[0];
+        int shown = (int)std::min<size_t>(cqe->res, first->iov_len);
+        LOGI("连接 %d 的缓冲数据实际发送 %d 字节；前 %d 字节：%s (%s)",
+             conn_index, cqe->res, std::min(shown, 128),
+             HEX_DUMP((const char*)first->iov_base, shown),
+             ASCII_DUMP((const char*)first->iov_base, shown));
+        pthread_mutex_lock(&send_mutexes[conn_index]);
+        consume_sent_bytes(conn_index, (size_t)cqe->res);
+        pthread_mutex_unlock(&send_mutexes[conn_index]);
+    } else if (cqe->res < 0 && cqe->res != -ECANCELED) {
+        LOGW("连接 %d 发送出错: (%d) %s", conn_index, -cqe->res, strerror(-cqe->res));
+        st->send_failed = true;
+    }
+
+    // 出错则关闭连接，否则继续提交剩余的数据（短写未发完的部分或新加入的节点）
+    if (st->closing || st->send_failed) {
+        uring_begin_close(conn_index);
+    } else if (running) {
+        uring_flush(reactor, conn_index);
+    }
+}
+
+// io_uring 后端的反应器事件循环
+static void reactor_loop_uring(Reactor* reactor) {
+    Uring* ring = &reactor->ring;
+
+    // 在 eventfd 上提交多发 poll，用于接收其他线程的唤醒
+    struct io_uring_sqe* sqe = ring->get_sqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = reactor->wake_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = make_uring_data(UOP_WAKE, -1);
+
+    while (running) {
+        // 提交积累的请求并等待完成事件，最多等待 1000ms
+        int ret = ring->submit_and_wait(1, 1000);
+        if (ret < 0 && ret != -ETIME && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+            LOGE("io_uring_enter: (%d) %s", -ret, strerror(-ret));
+            break;
+        }
+
+        struct io_uring_cqe* cqe;
+        while ((cqe = ring->peek_cqe()) != NULL) {
+            struct io_uring_cqe c = *cqe;
+            ring->cqe_seen();
+            switch (uring_data_op(c.user_data)) {
+            case UOP_WAKE:
+                uring_on_wake(reactor);
+                if (!(c.flags & IORING_CQE_F_MORE)) {
+                    sqe = ring->get_sqe();
+                    sqe->opcode = IORING_OP_POLL_ADD;
+                    sqe->fd = reactor->wake_fd;
+                    sqe->poll32_events = POLLIN;
+                    sqe->len = IORING_POLL_ADD_MULTI;
+                    sqe->user_data = make_uring_data(UOP_WAKE, -1);
+                }
+                break;
+            case UOP_RECV:
+                uring_on_recv(reactor, &c);
+                break;
+            case UOP_SEND:
+                uring_on_send(reactor, &c);
+                break;
+            case UOP_CONNECT:
+                uring_on_connect(reactor, &c);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    // 退出前取消所有在途请求并等待其结束，之后连接的缓冲才能由主线程释放
+    sqe = ring->get_sqe();
+    if (sqe != NULL) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+        sqe->user_data = 0;
+    }
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += 2;
+    while (true) {
+        bool busy = false;
+        for (int i = 0; i < g_connections_len; i++) {
+            if (conn_reactors[i] == reactor->id && uring_conns[i].ops > 0) busy = true;
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (!busy || now.tv_sec > deadline.tv_sec ||
+            (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec)) {
+            break;
+        }
+        ring->submit_and_wait(1, 100);
+        struct io_uring_cqe* cqe;
+        while ((cqe = ring->peek_cqe()) != NULL) {
+            struct io_uring_cqe c = *cqe;
+            ring->cqe_seen();
+            if (uring_data_op(c.user_data) == UOP_RECV) uring_on_recv(reactor, &c);
+            else if (uring_data_op(c.user_data) == UOP_SEND) uring_on_send(reactor, &c);
+            else if (uring_data_op(c.user_data) == UOP_CONNECT) uring_on_connect(reactor, &c);
+        }
+    }
+}
+
+// io_uring 后端的监听循环：以多发 accept 接受新连接
+static void run_acceptor_uring() {
+    Uring ring;
+    int ret = ring.init(64);
+    if (ret < 0) {
+        LOGW("监听线程创建 io_uring 失败: (%d) %s，改用 epoll", -ret, strerror(-ret));
+        run_acceptor_epoll();
+        return;
+    }
+
+    bool armed = false;
+    bool wake_armed = false;
+    while (running) {
+        if (!armed) {
+            struct io_uring_sqe* sqe = ring.get_sqe();
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->fd = server_fd;
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe->user_data = make_uring_data(UOP_ACCEPT, -1);
+            armed = true;
+        }
+        if (!wake_armed) {
+            // 其他线程提交重连请求时通过 eventfd 唤醒
+            struct io_uring_sqe* sqe = ring.get_sqe();
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = acceptor_wake_fd;
+            sqe->poll32_events = POLLIN;
+            sqe->len = IORING_POLL_ADD_MULTI;
+            sqe->user_data = make_uring_data(UOP_WAKE, -1);
+            wake_armed = true;
+        }
+        // 如果没有新的连接请求，则最多等待 1000ms 或到最近的重连时刻
+        int timeout = reconnect_wheel.next_timeout(monotonic_ms(), 1000);
+        ret = ring.submit_and_wait(1, timeout);
+        if (ret < 0 && ret != -ETIME && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+            LOGE("io_uring_enter: (%d) %s", -ret, strerror(-ret));
+            break;
+        }
+
+        struct io_uring_cqe* cqe;
+        while ((cqe = ring.peek_cqe()) != NULL) {
+            int res = cqe->res;
+            bool more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+            bool wake = uring_data_op(cqe->user_data) == UOP_WAKE;
+            ring.cqe_seen();
+
+            if (wake) {
+                if (!more) wake_armed = false;
+                continue;   // eventfd 在 run_reconnect_timers() 中读空
+            }
+            if (!more) armed = false;
+
+            if (res < 0) {
+                if (res != -EAGAIN && res != -EINTR && res != -ECANCELED) {
+                    LOGE("accept: (%d) %s", -res, strerror(-res));
+                }
+                continue;
+            }
+            // 多发 accept 不返回对端地址，通过 getpeername 获取
+            struct sockaddr_in client_addr;
+            socklen_t client_len = sizeof(client_addr);
+            if (getpeername(res, (struct sockaddr*)&client_addr, &client_len) < 0) {
+                LOG_SYSERR("getpeername");
+                close(res);
+                continue;
+            }
+            admit_passive_connection(res, &client_addr);
+        }
+        run_reconnect_timers();
+    }
+    ring.destroy();
+}
+
+// epoll 后端的监听循环
+static void run_acceptor_epoll() {
+    struct epoll_event events[MAX_EVENTS];
+
+    while (running) {
+        // 如果没有新的连接请求，则最多等待 1000ms 或到最近的重连时刻
+        int timeout = reconnect_wheel.next_timeout(monotonic_ms(), 1000);
+        int nfds = epoll_wait(listen_epoll_fd, events, MAX_EVENTS, timeout);
+
+        if (nfds < 0) {
+            if (errno == EINTR) continue;
+            LOG_SYSERR("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < nfds; i++) {
+            if (events[i].data.u64 == LISTEN_TOKEN) {
+                // 新的被动连接
+                handle_new_connection(server_fd);
+            }
+        }
+        run_reconnect_timers();
+    }
+}
+
+// 第 attempts 次连续失败后的退避时间：初始值逐次翻倍直到上限，再随机缩短至多 RECONNECT_JITTER_PCT%
+static int reconnect_delay_ms(int attempts) {
+    long long delay = RECONNECT_INITIAL_MS;
+    for (int i = 0; i < attempts && delay < RECONNECT_MAX_MS; i++) {
+        delay *= 2;
+    }
+    if (delay > RECONNECT_MAX_MS) delay = RECONNECT_MAX_MS;
+    long long jitter = delay * RECONNECT_JITTER_PCT / 100;
+    if (jitter > 0) {
+        delay -= rand_r(&reconnect_seed) % (jitter + 1);
+    }
+    return (int)delay;
+}
+
+// 为主动连接设置下一次重连的时刻，只在主线程调用
+// connect_failed 为 false 表示已建立的连接断开，此时退避从初始值重新开始
+static void schedule_reconnect(int conn_index, bool connect_failed) {
+    if (!connect_failed) {
+        reconnect_attempts[conn_index] = 0;
+    }
+    int delay = reconnect_delay_ms(reconnect_attempts[conn_index]);
+    if (reconnect_attempts[conn_index] < 32) {
+        reconnect_attempts[conn_index]++;
+    }
+    reconnect_wheel.schedule(&reconnect_timers[conn_index], monotonic_ms() + delay);
+    LOGI("%d 毫秒后重连到 %s:%d（连续失败 %d 次）", delay,
+         g_connections[conn_index].ip, g_connections[conn_index].port,
+         connect_failed ? reconnect_attempts[conn_index] : 0);
+}
+
+// 请求主线程为主动连接安排重连，可在任意线程调用
+static void request_reconnect(int conn_index, bool connect_failed) {
+    pthread_mutex_lock(&reconnect_mutex);
+    pending_reconnects.push_back(std::make_pair(conn_index, connect_failed));
+    pthread_mutex_unlock(&reconnect_mutex);
+    uint64_t one = 1;
+    if (write(acceptor_wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        LOG_SYSERR("write eventfd");
+    }
+}
+
+// 重连定时器到期
+static void on_reconnect_timer(TimerNode* timer) {
+    int conn_index = timer->id;
+    if (!running || g_connections[conn_index].socket != -1) return;
+    LOGI("尝试重连到 %s:%d", g_connections[conn_index].ip, g_connections[conn_index].port);
+    // 连接立即失败时直接安排下一次；非阻塞连接的结果由反应器通过 request_reconnect 告知
+    if (!connect_to_server(conn_index)) {
+        schedule_reconnect(conn_index, true);
+    }
+}
+
+// 接收其他线程提交的重连请求，并触发已到期的重连定时器，在主线程的事件循环中每轮调用
+static void run_reconnect_timers() {
+    uint64_t value;
+    while (read(acceptor_wake_fd, &value, sizeof(value)) > 0) {}
+
+    std::vector<std::pair<int, bool> > requests;
+    pthread_mutex_lock(&reconnect_mutex);
+    requests.swap(pending_reconnects);
+    pthread_mutex_unlock(&reconnect_mutex);
+    for (size_t i = 0; i < requests.size(); i++) {
+        schedule_reconnect(requests[i].first, requests[i].second);
+    }
+
+    reconnect_wheel.advance(monotonic_ms(), on_reconnect_timer);
+}
+// 将消息放入目标连接的发送队列，并把连接登记到所属反应器的 ready 队列
+// batch 不为 NULL 时新登记的连接先记在 batch 中，由调用方在整批入队后调用 post_ready_batch()
+// reserved 为 true 表示调用方已经用 reserve_fragment_space() 为整组分片占用了额度，失败时由调用方归还
+// 连接尚未交给反应器或程序正在退出时返回 false
+static bool push_send_queue(const Message& msg, ReadyBatch* batch, bool reserved) {
+    int conn_index = msg.target_index;
+    int r = conn_reactors[conn_index];
+    if (r < 0) {
+        LOGW("连接 %d 未建立，丢弃待发送的消息", conn_index);
+        return false;
+    }
+    if (!reserved) {
+        int space = reserve_send_space(conn_index, message_wire_bytes(msg));
+        if (space == 0) {
+            return false;
+        } else if (space < 0) {
+            release_message(msg);   // 按 OVERFLOW_DROP_NEWEST 丢弃
+            return true;
+        }
+    }
+    while (!conn_send_queues[conn_index].try_push(msg)) {
+        if (!running) {
+            if (reserved) return false;
+            pthread_mutex_lock(&send_mutexes[conn_index]);
+            release_send_space(conn_index, message_wire_bytes(msg), 1);
+            pthread_mutex_unlock(&send_mutexes[conn_index]);
+            return false;
+        }
+        // 队列满时由生产者自己把消息移入发送缓冲，不能等待反应器：生产者可能就是所属反应器线程（如回显）
+        // 取消息由 send_mutexes[conn_index] 串行化，发送队列仍只有一个消费者
+        pthread_mutex_lock(&send_mutexes[conn_index]);
+        drain_conn_send_queue(conn_index);
+        pthread_mutex_unlock(&send_mutexes[conn_index]);
+    }
+    // 连接已经登记且反应器尚未开始取这个连接的消息时，无需再次登记
+    if (conn_send_scheduled[conn_index].exchange(true, std::memory_order_acq_rel)) {
+        return true;
+    }
+    if (batch != NULL) {
+        batch->conns[batch->count] = conn_index;
+        batch->reactors[batch->count] = r;
+        batch->count++;
+        return true;
+    }
+    Reactor* reactor = &reactors[r];
+    reactor->ready.try_push(conn_index);    // 每个连接至多登记一次，不会满
+    signal_reactor(reactor);
+    return true;
+}
+
+// 连接已放入 ready 队列后调用：自反应器上次清除标志以来第一个登记的生产者负责唤醒它
+// 入队（发布队列元素）与置标志之间、反应器清标志与取队列之间都有全屏障，
+// 因此反应器要么在清标志之后的这一轮中取到该连接，要么会被这个生产者再唤醒一次
+static void signal_reactor(Reactor* reactor) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!reactor->ready_signaled.exchange(true, std::memory_order_seq_cst)) {
+        wake_reactor(reactor);
+    }
+}
+
+// 把一批入队中登记的连接放入各自反应器的 ready 队列，每个反应器至多唤醒一次
+static void post_ready_batch(const ReadyBatch* batch) {
+    bool posted[MAX_REACTORS] = {};
+    for (int i = 0; i < batch->count; i++) {
+        reactors[batch->reactors[i]].ready.try_push(batch->conns[i]);
+        posted[batch->reactors[i]] = true;
+    }
+    for (int r = 0; r < g_reactor_count; r++) {
+        if (posted[r]) {
+            signal_reactor(&reactors[r]);
+        }
+    }
+}
+
+// 把连接发送队列中的消息组装为电文加入发送缓冲，连接已断开时丢弃，调用时需持有 send_mutexes[conn_index] 锁
+static void drain_conn_send_queue(int conn_index) {
+    Message batch[SEND_DRAIN_BATCH];
+    bool connected = g_connections[conn_index].socket != -1;
+    int n;
+    while ((n = conn_send_queues[conn_index].pop_batch(batch, SEND_DRAIN_BATCH)) > 0) {
+        size_t dropped_bytes = 0;
+        for (int i = 0; i < n; i++) {
+            if (connected) {
+                add_to_send_buffer(conn_index, batch[i]);
+            } else {
+                dropped_bytes += message_wire_bytes(batch[i]);
+                release_message(batch[i]);
+            }
+        }
+        if (!connected) {
+            release_send_space(conn_index, dropped_bytes, n);
+        }
+    }
+}
+
+// 消息组装为电文后的字节数
+static inline size_t message_wire_bytes(const Message& msg) {
+    return msg.length + ((msg.flags & MSG_FLAG_FRAMED) ? 0 : WireHead::head_length + WireHead::terminator_length);
+}
+
+// 为将要入队的 msgs 条共 bytes 字节的电文占用连接的待发送额度，超过上限时按连接的策略处理
+// 返回 1 表示已占用额度，0 表示失败，-1 表示按 OVERFLOW_DROP_NEWEST 丢弃新电文
+static int reserve_send_space(int conn_index, size_t bytes, size_t msgs) {
+    const SendQueueLimits& limits = conn_send_limits[conn_index];
+    for (;;) {
+        size_t queued_bytes = conn_queued_bytes[conn_index].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t queued_msgs = conn_queued_msgs[conn_index].fetch_add(msgs, std::memory_order_relaxed) + msgs;
+        if (queued_bytes <= limits.max_bytes && queued_msgs <= limits.max_msgs) {
+            if ((queued_bytes >= limits.high_bytes || queued_msgs >= limits.high_msgs) &&
+                !conn_above_high[conn_index].exchange(true, std::memory_order_acq_rel)) {
+                LOGW("连接 %d 待发送数据达到高水位：%zu 字节，%zu 条", conn_index, queued_bytes, queued_msgs);
+                if (watermark_callback != NULL) {
+                    watermark_callback(conn_index, true, queued_bytes, queued_msgs);
+                }
+            }
+            return 1;
+        }
+        // 超过上限，撤销占用后按策略处理
+        conn_queued_bytes[conn_index].fetch_sub(bytes, std::memory_order_relaxed);
+        conn_queued_msgs[conn_index].fetch_sub(msgs, std::memory_order_relaxed);
+        if (bytes > limits.max_bytes || msgs > limits.max_msgs) {
+            LOGW("电文长度 %zu 超过连接 %d 的待发送字节上限 %zu", bytes, conn_index, limits.max_bytes);
+            return 0;
+        }
+        switch (limits.policy) {
+        case OVERFLOW_BLOCK:
+            if (tls_reactor != NULL) {
+                LOGW("连接 %d 待发送数据超过上限，反应器线程中不能阻塞，入队失败", conn_index);
+                return 0;
+            }
+            if (!wait_send_space(conn_index, bytes, msgs)) return 0;
+            break;
+        case OVERFLOW_DROP_OLDEST:
+            if (drop_oldest_buffers(conn_index, bytes, msgs)) break;
+            // 没有可以丢弃的旧电文时丢弃新电文
+            conn_dropped_msgs[conn_index].fetch_add(msgs, std::memory_order_relaxed);
+            LOGD("连接 %d 待发送数据超过上限，丢弃新电文 %zu 字节", conn_index, bytes);
+            return -1;
+        case OVERFLOW_DROP_NEWEST:
+            conn_dropped_msgs[conn_index].fetch_add(msgs, std::memory_order_relaxed);
+            LOGD("连接 %d 待发送数据超过上限，丢弃新电文 %zu 字节", conn_index, bytes);
+            return -1;
+        default:
+            LOGW("连接 %d 待发送数据超过上限（%zu 字节，%zu 条），入队失败", conn_index,
+                 conn_queued_bytes[conn_index].load(std::memory_order_relaxed),
+                 conn_queued_msgs[conn_index].load(std::memory_order_relaxed));
+            return 0;
+        }
+    }
+}
+
+// 阻塞策略下等待连接的待发送数据回落到能容纳 msgs 条共 bytes 字节，每次至多等待 SEND_BLOCK_WAIT_MS 毫秒
+// 连接断开或程序退出时返回 false，否则返回 true 由调用方重新尝试占用额度
+static bool wait_send_space(int conn_index, size_t bytes, size_t msgs) {
+    const SendQueueLimits& limits = conn_send_limits[conn_index];
+    bool ok = true;
+    pthread_mutex_lock(&send_mutexes[conn_index]);
+    if (conn_queued_bytes[conn_index].load(std::memory_order_relaxed) + bytes > limits.max_bytes ||
+        conn_queued_msgs[conn_index].load(std::memory_order_relaxed) + msgs > limits.max_msgs) {
+        if (!running || g_connections[conn_index].socket == -1) {
+            ok = false;
+        } else {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += (long)SEND_BLOCK_WAIT_MS * 1000000;
+            ts.tv_sec += ts.tv_nsec / 1000000000;
+            ts.tv_nsec %= 1000000000;
+            send_space_waiters[conn_index]++;
+            pthread_cond_timedwait(&send_space_cvs[conn_index], &send_mutexes[conn_index], &ts);
+            send_space_waiters[conn_index]--;
+        }
+    }
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
+    return ok && running;
+}
+
+// 丢弃缓冲链中最早的尚未开始发送的电文，直到能容纳 msgs 条共 bytes 字节的新电文
+// 先把发送队列中的消息移入缓冲链；部分发送或已交给在途 sendmsg 的节点不丢弃，保证电文流完整
+// 丢弃了至少一条电文时返回 true
+static bool drop_oldest_buffers(int conn_index, size_t bytes, size_t msgs) {
+    const SendQueueLimits& limits = conn_send_limits[conn_index];
+    size_t freed_bytes = 0;
+    size_t freed_msgs = 0;
+    pthread_mutex_lock(&send_mutexes[conn_index]);
+    drain_conn_send_queue(conn_index);
+    SendBuffer** link = &send_buffers[conn_index];
+    SendBuffer* prev = NULL;
+    for (int pinned = send_pinned_nodes[conn_index]; *link != NULL && (pinned > 0 || (*link)->sent_bytes > 0); pinned--) {
+        prev = *link;
+        link = &prev->next;
+    }
+    while (*link != NULL &&
+           (conn_queued_bytes[conn_index].load(std::memory_order_relaxed) - freed_bytes + bytes > limits.max_bytes ||
+            conn_queued_msgs[conn_index].load(std::memory_order_relaxed) - freed_msgs + msgs > limits.max_msgs)) {
+        SendBuffer* buffer = *link;
+        *link = buffer->next;
+        freed_bytes += buffer->total_length;
+        freed_msgs++;
+        free_send_buffer(buffer);
+    }
+    if (*link == NULL) {
+        send_buffer_tails[conn_index] = prev;
+    }
+    if (freed_msgs > 0) {
+        release_send_space(conn_index, freed_bytes, freed_msgs);
+        conn_dropped_msgs[conn_index].fetch_add(freed_msgs, std::memory_order_relaxed);
+        LOGD("连接 %d 待发送数据超过上限，丢弃最早的 %zu 条电文共 %zu 字节", conn_index, freed_msgs, freed_bytes);
+    }
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
+    return freed_msgs > 0;
+}
+
+// 归还已写完或被丢弃的电文占用的额度，回落到低水位时通知并唤醒阻塞的生产者
+// 调用时需持有 send_mutexes[conn_index] 锁
+static void release_send_space(int conn_index, size_t bytes, size_t msgs) {
+    const SendQueueLimits& limits = conn_send_limits[conn_index];
+    size_t queued_bytes = conn_queued_bytes[conn_index].fetch_sub(bytes, std::memory_order_relaxed) - bytes;
+    size_t queued_msgs = conn_queued_msgs[conn_index].fetch_sub(msgs, std::memory_order_relaxed) - msgs;
+    if (queued_bytes <= limits.low_bytes && queued_msgs <= limits.low_msgs &&
+        conn_above_high[conn_index].load(std::memory_order_relaxed) &&
+        conn_above_high[conn_index].exchange(false, std::memory_order_acq_rel)) {
+        LOGI("连接 %d 待发送数据回落到低水位：%zu 字节，%zu 条", conn_index, queued_bytes, queued_msgs);
+        if (watermark_callback != NULL) {
+            watermark_callback(conn_index, false, queued_bytes, queued_msgs);
+        }
+    }
+    if (send_space_waiters[conn_index] > 0) {
+        pthread_cond_broadcast(&send_space_cvs[conn_index]);
+    }
+}
+
+// 为长度为 length、拆分为 chunks 段的电文体一次占用全部分段的额度，返回值同 reserve_send_space()
+// 各段随后以 push_send_queue(..., reserved = true) 入队：额度不足时整组失败或被丢弃，不会只有前几段入队，
+// 接收方因此不会残留收不完的分片消息
+static int reserve_fragment_space(int conn_index, size_t length, int chunks) {
+    size_t framing = (size_t)chunks * (WireHead::head_length + WireHead::terminator_length);
+    return reserve_send_space(conn_index, length + framing, chunks);
+}
+
+// 归还整组额度中第 from_chunk 段及其后各段（尚未入队）的部分
+static void release_fragment_space(int conn_index, size_t length, int from_chunk, int chunks) {
+    if (from_chunk >= chunks) return;
+    size_t framing = (size_t)(chunks - from_chunk) * (WireHead::head_length + WireHead::terminator_length);
+    pthread_mutex_lock(&send_mutexes[conn_index]);
+    release_send_space(conn_index, length - (size_t)from_chunk * MAX_MESSAGE_BODY_SIZE + framing, chunks - from_chunk);
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
+}
+
+// 设置连接待发送数据的上限、水位与超限策略，应在连接开始发送之前调用
+bool set_send_queue_limits(int conn_index, const SendQueueLimits& limits) {
+    if (conn_index < 0 || conn_index >= g_connections_len ||
+        limits.low_bytes > limits.high_bytes || limits.high_bytes > limits.max_bytes ||
+        limits.low_msgs > limits.high_msgs || limits.high_msgs > limits.max_msgs) {
+        LOGW("参数非法 conn_index=%d", conn_index);
+        return false;
+    }
+    pthread_mutex_lock(&send_mutexes[conn_index]);
+    conn_send_limits[conn_index] = limits;
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
+    return true;
+}
+
+// 设置水位通知的回调，为 NULL 时只打印日志
+void set_send_watermark_callback(WatermarkCallback callback) {
+    watermark_callback = callback;
+}
+
+// 查询连接待发送数据的深度
+bool get_send_queue_depth(int conn_index, SendQueueDepth* depth) {
+    if (conn_index < 0 || conn_index >= g_connections_len || depth == NULL) return false;
+    depth->bytes = conn_queued_bytes[conn_index].load(std::memory_order_relaxed);
+    depth->msgs = conn_queued_msgs[conn_index].load(std::memory_order_relaxed);
+    depth->dropped = conn_dropped_msgs[conn_index].load(std::memory_order_relaxed);
+    depth->above_high = conn_above_high[conn_index].load(std::memory_order_relaxed);
+    return true;
+}
+
+// 在反应器线程中取出连接发送队列中的全部消息并发送
+// 连接可能已经迁移到其他反应器，取消息由 send_mutexes[conn_index] 串行化，保证发送队列只有一个消费者
+static void send_ready_connection(Reactor* reactor, int conn_index) {
+    // 先清除登记标记再取消息，此后入队的生产者会重新登记
+    conn_send_scheduled[conn_index].exchange(false, std::memory_order_acq_rel);
+
+    pthread_mutex_lock(&send_mutexes[conn_index]);
+    drain_conn_send_queue(conn_index);
+    bool flush_here = false;
+    if (g_connections[conn_index].socket != -1) {
+        if (g_io_backend == IO_EPOLL) {
+            // 立即尝试一次发送，未发完的部分等待 EPOLLOUT
+            send_buffered_data(conn_index);
+        } else if (conn_reactors[conn_index] == reactor->id) {
+            flush_here = true;
+        } else {
+            // 由连接所属的反应器提交发送请求
+            request_flush(conn_index);
+        }
+    }
+    pthread_mutex_unlock(&send_mutexes[conn_index]);
+
+    if (flush_here) {
+        uring_flush(reactor, conn_index);
+    }
+}
+
+// 清除唤醒标志后取出 ready 队列中登记的连接并逐个发送，取空即返回事件循环，不在反应器线程上等待
+// 某个生产者尚未发布完队首元素时这一轮可能提前取空，该生产者发布后会看到已清除的标志并再次唤醒反应器
+static void drain_ready_queue(Reactor* reactor) {
+    int batch[SEND_DRAIN_BATCH];
+    reactor->ready_signaled.store(false, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int n;
+    while (running && (n = reactor->ready.pop_batch(batch, SEND_DRAIN_BATCH)) > 0) {
+        for (int i = 0; i < n; i++) {
+            send_ready_connection(reactor, batch[i]);
+        }
+    }
+}
+
+// 获取待发送电文线程
+// 
+// 一般来讲，此项目仅用于电文的收发，待发送电文是从别的进程获取的。 
+// 整个电文（含电文头）应该由业务进程组装，本项目仅负责发送数据，
+// 此类电文通过 add_to_send_queue_framed() 原样发送。
+// 未来可在此处阻塞/轮询业务模块或读取文件/消息队列以获取要发送的电文。
+void* get_sendmsg_thread(void* arg) {
+    while (running) {
+        // 占位：模拟周期性检查外部来源是否有新电文
+        // 在这里未来可以添加：
+        // 1. 读取文件 / 命名管道 / 消息队列
+        // 2. 从共享内存或业务模块获取待发送消息
+        // 3. 解析并加入到对应的 send_buffer
+        LOGD("get_sendmsg_thread 周期检查，占位实现");
+        // 等价于 sleep(1)
+        my_sleep_seconds(1);
+    }
+    return NULL;
+}
+
+// 将数据加入到发送队列，使用 std::string 作为输入
+// 如果数据长度超过 MAX_MESSAGE_BODY_SIZE ，则拆分为多个分片发送，接收方重组后作为一条消息交付
+bool add_to_send_queue_std_string(int conn_index, const std::string& data, const char* msgid) {
+    char msgid_copy[sizeof(MsgHead::msgid)];
+    if (conn_index < 0 || conn_index >= g_connections_len || !copy_msgid(msgid_copy, msgid)) {
+        LOGW("参数非法 conn_index=%d", conn_index);
+        return false;
+    }
+    if (data.empty()) {
+        LOGW("数据为空 conn_index=%d", conn_index);
+        return false;
+    }
+    if (!body_fits_delimited(data.data(), data.size())) {
+        return false;
+    }
+
+    size_t total = data.size();
+    size_t offset = 0;
+    int chunks;
+    int frag_id;
+    if (!plan_fragments(total, &chunks, &frag_id)) {
+        return false;
+    }
+
+    // 先把数据拆分拷贝到各段，内存不足时一段也不入队
+    std::vector<Message> msgs(chunks);
+    for (int i = 0; i < chunks; i++) {
+        size_t chunk_len = std::min(static_cast<size_t>(MAX_MESSAGE_BODY_SIZE),
+                                    total - offset);
+
+        Message& msg = msgs[i];
+        msg.length = static_cast<int>(chunk_len);
+        msg.target_index = conn_index;
+        msg.flags = 0;
+        mark_fragment(&msg, frag_id, i, chunks);
+        memcpy(msg.msgid, msgid_copy, sizeof(msg.msgid));
+        msg.data = (char*)pool_alloc(chunk_len);
+        msg.release = release_pool_body;
+        msg.release_ctx = NULL;
+        if (!msg.data) {
+            LOGE("内存分配失败 chunk_len=%zu", chunk_len);
+            for (int k = 0; k < i; k++) {
+                release_message(msgs[k]);
+            }
+            return false;
+        }
+        memcpy(msg.data, data.data() + offset, chunk_len);
+
+        offset += chunk_len;
+    }
+
+    // 拆分为多段时一次占用全部分段的额度，避免对端只收到前几段
+    bool reserved = chunks > 1;
+    if (reserved) {
+        int space = reserve_fragment_space(conn_index, total, chunks);
+        if (space <= 0) {
+            for (int i = 0; i < chunks; i++) {
+                release_message(msgs[i]);
+            }
+            return space < 0;   // 按 OVERFLOW_DROP_NEWEST 整组丢弃时视为成功
+        }
+    }
+    // 加入连接的发送队列，入队不加锁，必要时由 push_send_queue 唤醒连接所属的反应器
+    for (int i = 0; i < chunks; i++) {
+        if (!push_send_queue(msgs[i], NULL, reserved)) {
+            // 只在连接断开或程序退出时发生，对端的重组状态随连接一起丢弃
+            if (reserved) release_fragment_space(conn_index, total, i, chunks);
+            for (int k = i; k < chunks; k++) {
+                release_message(msgs[k]);
+            }
+            return false;
+        }
+    }
+
+    LOGI("已将消息加入发送队列，目标连接 %d，消息体总长度 %zu 字节，共分 %d 段；前 %d 字节：%s (%s)",
+         conn_index, total, chunks,
+         (int)std::min<size_t>(total, 128),
          HEX_DUMP(data.data(), total), ASCII_DUMP(data.data(), total));
 
     return true;
 }
 
+// 多段共享的电文体中一段发送完毕或被丢弃
+static void release_shared_body(char* data, void* ctx) {
+    (void)data;
+    SharedBody* shared = (SharedBody*)ctx;
+    if (shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (shared->release != NULL) {
+            shared->release(shared->data, shared->release_ctx);
+        }
+        shared->~SharedBody();
+        pool_free(shared);
+    }
+}
+
+// 将调用方移交的数据加入到发送队列，数据的所有权随消息一直传递到发送完毕，中间不做拷贝
+// 发送完毕、被丢弃或入队失败时以 (data, release_ctx) 调用 release；release 为 NULL 表示调用方自行管理，
+// 此时调用方须保证数据在发送完毕前有效
+// 如果数据长度超过 MAX_MESSAGE_BODY_SIZE ，则拆分为多个分片发送，各分片指向同一块数据
+// msgid 为 4 个字符的电文号，为 NULL 时使用默认电文号
+bool add_to_send_queue_buffer(int conn_index, char* data, size_t length, BodyRelease release, void* release_ctx,
+                              const char* msgid) {
+    if (conn_index < 0 || conn_index >= g_connections_len || data == NULL || length == 0) {
+        LOGW("参数非法 conn_index=%d length=%zu", conn_index, length);
+        if (release != NULL && data != NULL) release(data, release_ctx);
+        return false;
+    }
+
+    // 入队之后数据随时可能被反应器发送并释放，须在入队前打印
+    LOGI("将消息加入发送队列，目标连接 %d，消息体总长度 %zu 字节，共分 %d 段；前 %d 字节：%s (%s)",
+         conn_index, length, (int)((length + MAX_MESSAGE_BODY_SIZE - 1) / MAX_MESSAGE_BODY_SIZE),
+         (int)std::min<size_t>(length, 128),
+         HEX_DUMP(data, length), ASCII_DUMP(data, length));
+
+    return enqueue_body(conn_index, data, length, release, release_ctx, msgid, NULL);
+}
+
+// 把参数已校验的电文体按 MAX_MESSAGE_BODY_SIZE 拆分为分片后放入发送队列，batch 的含义同 push_send_queue()
+// 电文号非法、分隔符模式下电文体含分隔符、分片过多或失败时释放尚未入队的部分
+static bool enqueue_body(int conn_index, char* data, size_t length, BodyRelease release, void* release_ctx,
+                         const char* msgid, ReadyBatch* batch) {
+    int chunks;
+    int frag_id;
+    Message msg;
+    msg.target_index = conn_index;
+    msg.flags = 0;
+    if (!copy_msgid(msg.msgid, msgid) || !body_fits_delimited(data, length) ||
+        !plan_fragments(length, &chunks, &frag_id)) {
+        if (release != NULL) release(data, release_ctx);
+        return false;
+    }
+    if (chunks == 1) {
+        msg.data = data;
+        msg.length = (int)length;
+        msg.release = release;
+        msg.release_ctx = release_ctx;
+        if (!push_send_queue(msg, batch)) {
+            release_message(msg);
+            return false;
+        }
+        return true;
+    }
+
+    SharedBody* shared = (SharedBody*)pool_alloc(sizeof(SharedBody));
+    if (shared == NULL) {
+        LOGE("内存分配失败 conn_index=%d", conn_index);
+        if (release != NULL) release(data, release_ctx);
+        return false;
+    }
+    new (shared) SharedBody();
+    shared->refs.store(chunks, std::memory_order_relaxed);
+    shared->data = data;
+    shared->release = release;
+    shared->release_ctx = release_ctx;
+
+    // 一次占用全部分段的额度，各段要么全部入队，要么全部不入队
+    int space = reserve_fragment_space(conn_index, length, chunks);
+    if (space <= 0) {
+        for (int k = 0; k < chunks; k++) {
+            release_shared_body(NULL, shared);
+        }
+        return space < 0;   // 按 OVERFLOW_DROP_NEWEST 整组丢弃时视为成功
+    }
+
+    msg.release = release_shared_body;
+    msg.release_ctx = shared;
+    size_t offset = 0;
+    for (int i = 0; i < chunks; i++) {
+        msg.data = data + offset;
+        msg.length = (int)std::min(static_cast<size_t>(MAX_MESSAGE_BODY_SIZE), length - offset);
+        mark_fragment(&msg, frag_id, i, chunks);
+        if (!push_send_queue(msg, batch, true)) {
+            // 只在连接断开或程序退出时发生：归还本段及其后各段的额度与引用，已入队的段随连接清理
+            release_fragment_space(conn_index, length, i, chunks);
+            for (int k = i; k < chunks; k++) {
+                release_shared_body(NULL, shared);
+            }
+            return false;
+        }
+        offset += msg.length;
+    }
+    return true;
+}
+
+static void release_new_array(char* data, void* ctx) {
+    (void)ctx;
+    delete[] data;
+}
+
+// 将数据加入到发送队列，接管 unique_ptr 持有的数组，发送完毕后以 delete[] 释放
+bool add_to_send_queue_buffer(int conn_index, std::unique_ptr<char[]> data, size_t length, const char* msgid) {
+    return add_to_send_queue_buffer(conn_index, data.release(), length, release_new_array, NULL, msgid);
+}
+
+// 把 std::string 移入从内存池分配的字符串对象，只转移其存储，不拷贝电文体
+// 与电文体一同在反应器线程中由 release_moved_string() 析构并归还内存池，失败时返回 NULL
+static std::string* pool_move_string(std::string&& str) {
+    void* mem = pool_alloc(sizeof(std::string));
+    if (mem == NULL) {
+        LOGE("内存分配失败 length=%zu", str.size());
+        return NULL;
+    }
+    return new (mem) std::string(std::move(str));
+}
+
+static void release_moved_string(char* data, void* ctx) {
+    (void)data;
+    std::string* owned = (std::string*)ctx;
+    owned->~basic_string();
+    pool_free(owned);
+}
+
+// 将数据加入到发送队列，接管 std::string 的存储，不拷贝电文体
+bool add_to_send_queue_std_string(int conn_index, std::string&& data, const char* msgid) {
+    if (data.empty()) {
+        LOGW("数据为空 conn_index=%d", conn_index);
+        return false;
+    }
+    // 移动构造只转移字符串的堆存储，短字符串（SSO）才会拷贝少量字节
+    std::string* owned = pool_move_string(std::move(data));
+    if (owned == NULL) return false;
+    return add_to_send_queue_buffer(conn_index, &(*owned)[0], owned->size(), release_moved_string, owned, msgid);
+}
+
+// 批量将消息加入发送队列，用于突发的大量电文：
+// 整批入队完成后才把新登记的连接放入反应器的 ready 队列，每个反应器至多唤醒一次
+// 每条消息的所有权与 add_to_send_queue_buffer() 相同；log_each 为 false 时只打印一条汇总日志
+// 返回成功入队的消息数
+size_t add_to_send_queue_batch(const BatchSendItem* items, size_t count, bool log_each) {
+    ReadyBatch batch;
+    batch.count = 0;
+    size_t queued = 0;
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        const BatchSendItem& item = items[i];
+        if (item.conn_index < 0 || item.conn_index >= g_connections_len || item.data == NULL || item.length == 0) {
+            LOGW("参数非法 conn_index=%d length=%zu", item.conn_index, item.length);
+            if (item.release != NULL && item.data != NULL) item.release(item.data, item.release_ctx);
+            continue;
+        }
+        if (log_each) {
+            LOGI("将消息加入发送队列，目标连接 %d，消息体总长度 %zu 字节；前 %d 字节：%s (%s)",
+                 item.conn_index, item.length, (int)std::min<size_t>(item.length, 128),
+                 HEX_DUMP(item.data, item.length), ASCII_DUMP(item.data, item.length));
+        }
+        if (enqueue_body(item.conn_index, item.data, item.length, item.release, item.release_ctx, item.msgid, &batch)) {
+            queued++;
+            bytes += item.length;
+        }
+    }
+    post_ready_batch(&batch);
+    LOGI("批量加入发送队列 %zu 条消息，成功 %zu 条共 %zu 字节，涉及 %d 个连接", count, queued, bytes, batch.count);
+    return queued;
+}
+
+// 批量将消息加入发送队列，接管各 std::string 的存储
+size_t add_to_send_queue_batch(std::vector<std::pair<int, std::string>>&& items, bool log_each) {
+    std::vector<BatchSendItem> batch;
+    batch.reserve(items.size());
+    for (size_t i = 0; i < items.size(); i++) {
+        if (items[i].second.empty()) {
+            LOGW("数据为空 conn_index=%d", items[i].first);
+            continue;
+        }
+        std::string* owned = pool_move_string(std::move(items[i].second));
+        if (owned == NULL) continue;
+        batch.push_back({items[i].first, &(*owned)[0], owned->size(), release_moved_string, owned, NULL});
+    }
+    items.clear();
+    return add_to_send_queue_batch(batch.data(), batch.size(), log_each);
+}
+
+// 校验已成帧电文的电文头：长度字段合法（默认格式下 length、date、time、seqno 须为十进制数字），
+// 描述的电文长度与电文的实际长度一致，且以结束符结束；分隔符模式下电文须以分隔符结束且中间不含分隔符
+static bool validate_frame_length(const char* frame, size_t length) {
+    if (length <= (size_t)(WireHead::head_length + WireHead::terminator_length) || length > MAX_MESSAGE_SIZE) {
+        return false;
+    }
+    const char* terminator = frame + length - WireHead::terminator_length;
+    if (memcmp(terminator, WireHead::terminator(), WireHead::terminator_length) != 0) return false;
+    if constexpr (WireHead::delimited) {
+        return scan_byte(frame, length - 1, WireHead::delimiter) == NULL;
+    } else {
+        int body_len = WireCodec::body_length(frame);
+        return body_len > 0 && WireCodec::frame_length(body_len) == (int)length;
+    }
+}
+
+// 将业务进程已经组装好的完整电文（含电文头）加入到发送队列
+// 只校验电文头的 length 字段，不生成电文头、不拷贝，电文按原样写入套接字
+// 数据的所有权与 add_to_send_queue_buffer() 相同：发送完毕、被丢弃或校验、入队失败时调用 release
+bool add_to_send_queue_framed(int conn_index, char* frame, size_t length, BodyRelease release, void* release_ctx) {
+    if (conn_index < 0 || conn_index >= g_connections_len || frame == NULL) {
+        LOGW("参数非法 conn_index=%d length=%zu", conn_index, length);
+        if (release != NULL && frame != NULL) release(frame, release_ctx);
+        return false;
+    }
+    if (!validate_frame_length(frame, length)) {
+        LOGW("已成帧电文的电文头非法或长度字段与实际长度 %zu 不符，丢弃，目标连接 %d；前 %d 字节：%s (%s)",
+             length, conn_index, (int)std::min<size_t>(length, 128),
+             HEX_DUMP(frame, length), ASCII_DUMP(frame, length));
+        if (release != NULL) release(frame, release_ctx);
+        return false;
+    }
+
+    // 入队之后数据随时可能被反应器发送并释放，须在入队前打印
+    LOGI("将已成帧电文加入发送队列，目标连接 %d，电文总长度 %zu 字节；前 %d 字节：%s (%s)",
+         conn_index, length, (int)std::min<size_t>(length, 128),
+         HEX_DUMP(frame, length), ASCII_DUMP(frame, length));
+
+    Message msg;
+    msg.data = frame;
+    msg.length = (int)length;
+    msg.target_index = conn_index;
+    msg.flags = MSG_FLAG_FRAMED;
+    msg.release = release;
+    msg.release_ctx = release_ctx;
+    if (!push_send_queue(msg)) {
+        release_message(msg);
+        return false;
+    }
+    return true;
+}
+
+// 将完整电文加入到发送队列，接管 std::string 的存储
+bool add_to_send_queue_framed(int conn_index, std::string&& frame) {
+    if (frame.empty()) {
+        LOGW("数据为空 conn_index=%d", conn_index);
+        return false;
+    }
+    std::string* owned = pool_move_string(std::move(frame));
+    if (owned == NULL) return false;
+    return add_to_send_queue_framed(conn_index, &(*owned)[0], owned->size(), release_moved_string, owned);
+}
+
+// 向多个连接发送同一条消息：电文体只拷贝一次，各连接的发送队列引用同一块带引用计数的电文体，
+// 全部连接写完（或丢弃）后才释放；电文头按各连接的模板（DC 不同）在组装时生成，只占节点内的 40 字节
+// 调用返回后调用方即可释放 data；超过 MAX_MESSAGE_BODY_SIZE 时拆分为多个分片
+// 返回全部分段都成功加入发送队列的连接数，重复或非法的下标被忽略；分配内存失败时不入队任何连接，返回 0
+int broadcast_send(const int* conn_indices, int count, const char* data, size_t length, const char* msgid) {
+    Message msg;
+    int chunks;
+    int frag_id;
+    if (data == NULL || length == 0 || !copy_msgid(msg.msgid, msgid)) {
+        LOGW("数据为空或电文号非法，忽略广播");
+        return 0;
+    }
+    if (!body_fits_delimited(data, length) || !plan_fragments(length, &chunks, &frag_id)) {
+        return 0;
+    }
+    // 去掉重复与非法的下标，保证每个连接只收到一份
+    int targets[g_connections_len];
+    int target_count = 0;
+    bool seen[g_connections_len] = {};
+    for (int i = 0; i < count; i++) {
+        int conn_index = conn_indices[i];
+        if (conn_index < 0 || conn_index >= g_connections_len) {
+            LOGW("参数非法 conn_index=%d", conn_index);
+            continue;
+        }
+        if (seen[conn_index]) continue;
+        seen[conn_index] = true;
+        targets[target_count++] = conn_index;
+    }
+    if (target_count == 0) return 0;
+
+    LOGI("广播消息到 %d 个连接，消息体总长度 %zu 字节；前 %d 字节：%s (%s)",
+         target_count, length, (int)std::min<size_t>(length, 128),
+         HEX_DUMP(data, length), ASCII_DUMP(data, length));
+
+    // 先为每一段分配并拷贝电文体，全部成功后才入队，避免部分连接只收到前几段
+    // 每个目标连接对每一段持有一个引用，入队失败的连接立即归还
+    std::vector<SharedBody*> shared(chunks, (SharedBody*)NULL);
+    size_t offset = 0;
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        int body_len = (int)std::min(static_cast<size_t>(MAX_MESSAGE_BODY_SIZE), length - offset);
+        char* body = (char*)pool_alloc(body_len);
+        SharedBody* body_ref = (SharedBody*)pool_alloc(sizeof(SharedBody));
+        if (body == NULL || body_ref == NULL) {
+            LOGE("内存分配失败 body_len=%d", body_len);
+            pool_free(body);
+            pool_free(body_ref);
+            for (int k = 0; k < chunk; k++) {
+                pool_free(shared[k]->data);
+                shared[k]->~SharedBody();
+                pool_free(shared[k]);
+            }
+            return 0;
+        }
+        memcpy(body, data + offset, body_len);
+        new (body_ref) SharedBody();
+        body_ref->refs.store(target_count, std::memory_order_relaxed);
+        body_ref->data = body;
+        body_ref->release = release_pool_body;
+        body_ref->release_ctx = NULL;
+        shared[chunk] = body_ref;
+        offset += body_len;
+    }
+
+    // 逐个连接依次放入全部分段，拆分为多段时先为该连接一次占用全部分段的额度；
+    // 额度不足或某一段入队失败的连接其余各段不再入队，该连接不计入成功数
+    ReadyBatch batch;
+    batch.count = 0;
+    int delivered_count = 0;
+    bool reserved = chunks > 1;
+    msg.release = release_shared_body;
+    for (int i = 0; i < target_count; i++) {
+        int conn_index = targets[i];
+        msg.target_index = conn_index;
+        int space = reserved ? reserve_fragment_space(conn_index, length, chunks) : 1;
+        bool complete = space != 0;
+        int chunk = 0;
+        if (space > 0) {
+            for (; chunk < chunks; chunk++) {
+                msg.data = shared[chunk]->data;
+                msg.length = (int)std::min(static_cast<size_t>(MAX_MESSAGE_BODY_SIZE),
+                                           length - (size_t)chunk * MAX_MESSAGE_BODY_SIZE);
+                msg.flags = 0;
+                mark_fragment(&msg, frag_id, chunk, chunks);
+                msg.release_ctx = shared[chunk];
+                if (!push_send_queue(msg, &batch, reserved)) {
+                    complete = false;
+                    break;
+                }
+            }
+            if (!complete && reserved) release_fragment_space(conn_index, length, chunk, chunks);
+        }
+        // 未入队（失败或按 OVERFLOW_DROP_NEWEST 整组丢弃）的各段归还该连接的引用
+        for (; chunk < chunks; chunk++) {
+            release_shared_body(NULL, shared[chunk]);
+        }
+        if (complete) delivered_count++;
+    }
+    post_ready_batch(&batch);
+    return delivered_count;
+}
+
+// 向 pred 选中的已连接的连接广播，pred 为 NULL 时发送给全部已连接的连接
+// 例如选中全部主动连接：[](int, const Commloop& c, void*) { return c.as_server == 0; }
+int broadcast_send_if(ConnPredicate pred, void* ctx, const char* data, size_t length, const char* msgid) {
+    int targets[g_connections_len];
+    int count = 0;
+    pthread_mutex_lock(&connections_mutex);
+    for (int i = 0; i < g_connections_len; i++) {
+        if (g_connections[i].socket == -1) continue;
+        if (pred == NULL || pred(i, g_connections[i], ctx)) {
+            targets[count++] = i;
+        }
+    }
+    pthread_mutex_unlock(&connections_mutex);
+    return broadcast_send(targets, count, data, length, msgid);
+}
+
 // 从文件加载连接配置，以 JSON 格式【未测试】
 std::vector<Commloop> load_connections(const std::string& filename) {
     std::ifstream fin(filename);
@@ -673,6 +2703,16 @@ std::vector<Commloop> load_connections(const std::string& filename) {
         strcpy(c.ip, item["ip"].get<std::string>().c_str());
         c.port = item["port"];
         c.as_server = item["as_server"];
+        // DC 为可选字段，缺省时使用默认值；给出时须恰好为两个字符，否则跳过该连接
+        std::string senddc = item.value("senddc", std::string());
+        std::string recvdc = item.value("recvdc", std::string());
+        if ((!senddc.empty() && senddc.size() != 2) || (!recvdc.empty() && recvdc.size() != 2)) {
+            LOGE("连接 %s:%d 的 DC 非法（senddc=\"%s\"，recvdc=\"%s\"），须为两个字符，跳过该连接",
+                 c.ip, c.port, senddc.c_str(), recvdc.c_str());
+            continue;
+        }
+        snprintf(c.senddc, sizeof(c.senddc), "%s", senddc.c_str());
+        snprintf(c.recvdc, sizeof(c.recvdc), "%s", recvdc.c_str());
         result.push_back(c);
     }
     return result;
@@ -686,7 +2726,9 @@ void save_connections(const std::string& filename, const std::vector<Commloop>&
             {"socket", c.socket},
             {"ip", c.ip},
             {"port", c.port},
-            {"as_server", c.as_server}
+            {"as_server", c.as_server},
+            {"senddc", c.senddc},
+            {"recvdc", c.recvdc}
         });
     }
     std::ofstream fout(filename);
@@ -694,13 +2736,54 @@ void save_connections(const std::string& filename, const std::vector<Commloop>&
 }
 
 // 主函数
-int main() {
+// 用法：socket_comm [-r 反应器线程数] [-b epoll|uring]
+// 默认每个在线 CPU 一个反应器；I/O 后端默认为 epoll，以 -DUSE_IO_URING 编译时默认为 io_uring
+int main(int argc, char* argv[]) {
+    int reactor_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int opt;
+    while ((opt = getopt(argc, argv, "r:b:")) != -1) {
+        switch (opt) {
+        case 'r':
+            reactor_count = atoi(optarg);
+            break;
+        case 'b':
+            if (strcmp(optarg, "uring") == 0) {
+                g_io_backend = IO_URING;
+            } else if (strcmp(optarg, "epoll") == 0) {
+                g_io_backend = IO_EPOLL;
+            } else {
+                fprintf(stderr, "未知的 I/O 后端: %s\n", optarg);
+                return 1;
+            }
+            break;
+        default:
+            fprintf(stderr, "用法: %s [-r 反应器线程数] [-b epoll|uring]\n", argv[0]);
+            return 1;
+        }
+    }
+    g_reactor_count = std::max(1, std::min(reactor_count, MAX_REACTORS));
+
     signal(SIGINT, signal_handler);     // 处理 Ctrl+C 终止信号
     signal(SIGTERM, signal_handler);    // 处理 kill 命令的终止信号
     signal(SIGPIPE, SIG_IGN);           // 忽略 SIGPIPE 信号，防止写断开的 socket 导致程序退出
 
-    // 初始化接收缓冲
-    memset(receive_buffers, 0, sizeof(receive_buffers));
+    // 初始化每个连接的状态
+    for (int i = 0; i < g_connections_len; i++) {
+        receive_buffers[i].reset();
+        conn_reactors[i] = -1;
+        pthread_mutex_init(&send_mutexes[i], NULL);
+        pthread_cond_init(&send_space_cvs[i], NULL);
+        conn_send_queues[i].init();
+        build_head_template(i);
+        SendQueueLimits& limits = conn_send_limits[i];
+        limits.max_bytes = SEND_LIMIT_BYTES;
+        limits.max_msgs = SEND_LIMIT_MSGS;
+        limits.high_bytes = SEND_LIMIT_BYTES / 4 * 3;
+        limits.high_msgs = SEND_LIMIT_MSGS / 4 * 3;
+        limits.low_bytes = SEND_LIMIT_BYTES / 4;
+        limits.low_msgs = SEND_LIMIT_MSGS / 4;
+        limits.policy = OVERFLOW_FAIL;
+    }
 
     // 创建服务器套接字，用于监听连接请求
     server_fd = create_server_socket();
@@ -709,9 +2792,50 @@ int main() {
         return 1;
     }
 
-    // 创建 epoll 实例，使用 epoll 统一管理所有 socket 的收发和连接状态
-    epoll_fd = epoll_create1(0);
-    if (epoll_fd < 0) {
+    // 为每个反应器创建独立的 epoll 实例，使用 epoll 统一管理分配到该反应器的 socket 的收发和连接状态
+    // 其他线程通过 wake_fd 唤醒反应器发送消息
+    for (int r = 0; r < g_reactor_count; r++) {
+        reactors[r].id = r;
+        reactors[r].load = 0;
+        reactors[r].epoll_fd = epoll_create1(0);
+        if (reactors[r].epoll_fd < 0) {
+            LOG_SYSERR("epoll_create1");
+            return 1;
+        }
+        reactors[r].wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (reactors[r].wake_fd < 0) {
+            LOG_SYSERR("eventfd");
+            return 1;
+        }
+        reactors[r].ready.init();
+        reactors[r].ready_signaled = false;
+    }
+    // 内核不支持所需的 io_uring 特性时退回 epoll
+    if (g_io_backend == IO_URING) {
+        for (int r = 0; r < g_reactor_count; r++) {
+            if (!init_uring_reactor(&reactors[r])) {
+                for (int k = 0; k < r; k++) {
+                    destroy_uring_reactor(&reactors[k]);
+                }
+                LOGW("io_uring 不可用，改用 epoll");
+                g_io_backend = IO_EPOLL;
+                break;
+            }
+        }
+    }
+    // epoll 后端的反应器在自己的 epoll 实例中等待 wake_fd；io_uring 后端以多发 poll 等待
+    if (g_io_backend == IO_EPOLL) {
+        for (int r = 0; r < g_reactor_count; r++) {
+            struct epoll_event wake_ev;
+            wake_ev.events = EPOLLIN;
+            wake_ev.data.u64 = REACTOR_WAKE_TOKEN;
+            epoll_ctl(reactors[r].epoll_fd, EPOLL_CTL_ADD, reactors[r].wake_fd, &wake_ev);
+        }
+    }
+
+    // 创建监听用的 epoll 实例，由主线程等待新的连接请求
+    listen_epoll_fd = epoll_create1(0);
+    if (listen_epoll_fd < 0) {
         LOG_SYSERR("epoll_create1");
         close(server_fd);
         return 1;
@@ -720,106 +2844,93 @@ int main() {
     // 将服务器套接字加入 epoll
     struct epoll_event ev;
     ev.events = EPOLLIN;
-    ev.data.fd = server_fd;
+    ev.data.u64 = LISTEN_TOKEN;
     // 向 epoll 对象中添加感兴趣的事件，socket server_fd 的可读事件
-    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd, &ev);
+    epoll_ctl(listen_epoll_fd, EPOLL_CTL_ADD, server_fd, &ev);
 
-    // 主动连接远端服务器
+    // 重连定时器由主线程的事件循环驱动，其他线程通过 eventfd 唤醒主线程
+    acceptor_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (acceptor_wake_fd < 0) {
+        LOG_SYSERR("eventfd");
+        return 1;
+    }
+    ev.events = EPOLLIN;
+    ev.data.u64 = ACCEPTOR_WAKE_TOKEN;
+    epoll_ctl(listen_epoll_fd, EPOLL_CTL_ADD, acceptor_wake_fd, &ev);
+    reconnect_wheel.init(monotonic_ms());
+    reconnect_seed = (unsigned int)time(NULL) ^ (unsigned int)getpid();
     for (int i = 0; i < g_connections_len; i++) {
-        if (g_connections[i].as_server == 0) {
-            connect_to_server(i);
-        }
+        reconnect_timers[i].id = i;
     }
 
-    // 启动连接管理线程
-    pthread_t conn_manager_tid;
-    pthread_create(&conn_manager_tid, NULL, connection_manager_thread, NULL);
 
-    // 启动发送线程
-    pthread_t send_tid;
-    pthread_create(&send_tid, NULL, send_thread, NULL);
+    // 启动反应器线程
+    for (int r = 0; r < g_reactor_count; r++) {
+        pthread_create(&reactors[r].tid, NULL, reactor_thread, &reactors[r]);
+    }
+
+    // 主动连接远端服务器，立即失败的连接交给重连定时器
+    for (int i = 0; i < g_connections_len; i++) {
+        if (g_connections[i].as_server == 0 && !connect_to_server(i)) {
+            schedule_reconnect(i, true);
+        }
+    }
 
     // 启动获取待发送电文线程
     pthread_t get_sendmsg_tid;
     pthread_create(&get_sendmsg_tid, NULL, get_sendmsg_thread, NULL);
 
-    // 主事件循环
-    struct epoll_event events[MAX_EVENTS];
-    LOGI("服务已启动，进入主循环...");
-
-    while (running) {
-        // 收集在 epoll 监控的事件中已经发生的事件，如果 epoll 中没有任何一个事件发生，则最多等待 1000ms
-        int nfds = epoll_wait(epoll_fd, events, MAX_EVENTS, 1000);
-
-        if (nfds < 0) {
-            if (errno == EINTR) continue;
-            LOG_SYSERR("epoll_wait");
-            break;
-        }
-
-        for (int i = 0; i < nfds; i++) {
-            int fd = events[i].data.fd;
-            // 当发生事件的文件描述符为服务器套接字时，表示有新的连接请求
-            if (fd == server_fd) {
-                // 新的被动连接
-                handle_new_connection(server_fd);
-            } else {
-                // 已有连接上的事件
-                int conn_index = find_connection_by_socket(fd);
-                if (conn_index != -1) {
-                    // 表示对应的文件描述符可以读（包括对端SOCKET正常关闭）
-                    if (events[i].events & EPOLLIN) {
-                        LOGD("EPOLL 发现连接 %d 有数据可读，尝试读取数据", conn_index);
-                        handle_client_data(conn_index);
-                    }
-                    // 表示对应的文件描述符可以写，此时尝试发送缓冲区的数据
-                    if (events[i].events & EPOLLOUT) {
-                        LOGD("EPOLL 发现连接 %d 可写，尝试发送缓冲区数据", conn_index);
-                        pthread_mutex_lock(&connections_mutex);
-                        bool success = send_buffered_data(conn_index);
-                        pthread_mutex_unlock(&connections_mutex);
-                        if (!success) {
-                            handle_client_disconnect(conn_index);
-                        }
-                    }
-                    // 连接关闭或错误
-                    if (events[i].events & (EPOLLHUP | EPOLLERR)) {
-                        handle_client_disconnect(conn_index);
-                    }
-                }
-            }
-        }
+    // 主循环只负责接受新连接，连接上的收发由反应器线程处理
+    LOGI("服务已启动，反应器线程数 %d，I/O 后端 %s，进入主循环...",
+         g_reactor_count, g_io_backend == IO_URING ? "io_uring" : "epoll");
+    if (g_io_backend == IO_URING) {
+        run_acceptor_uring();
+    } else {
+        run_acceptor_epoll();
     }
 
     // 清理
     LOGI("正在关闭...");
+    running = false;
 
-    // 唤醒可能在等待的发送线程
-    pthread_mutex_lock(&send_queue_mutex);
-    pthread_cond_broadcast(&send_queue_cv);
-    pthread_mutex_unlock(&send_queue_mutex);
     // 唤醒处于定时等待的线程
     pthread_mutex_lock(&lifecycle_mutex);
     pthread_cond_broadcast(&lifecycle_cv);
     pthread_mutex_unlock(&lifecycle_mutex);
     // 线程将在下一轮检查 running 后自然退出
-    pthread_join(conn_manager_tid, NULL);
-    pthread_join(send_tid, NULL);
     pthread_join(get_sendmsg_tid, NULL);
+    for (int r = 0; r < g_reactor_count; r++) {
+        pthread_join(reactors[r].tid, NULL);
+    }
 
     for (int i = 0; i < g_connections_len; i++) {
+        // 反应器尚未取走的消息也在关闭前尽量发出
+        pthread_mutex_lock(&send_mutexes[i]);
+        drain_conn_send_queue(i);
+        pthread_mutex_unlock(&send_mutexes[i]);
         cleanup_connection(i, true);
     }
 
     close(server_fd);
-    close(epoll_fd);
+    close(listen_epoll_fd);
+    close(acceptor_wake_fd);
+    for (int r = 0; r < g_reactor_count; r++) {
+        close(reactors[r].epoll_fd);
+        close(reactors[r].wake_fd);
+        if (g_io_backend == IO_URING) {
+            destroy_uring_reactor(&reactors[r]);
+        }
+    }
 
     pthread_mutex_destroy(&connections_mutex);
-    pthread_mutex_destroy(&send_queue_mutex);
-    pthread_cond_destroy(&send_queue_cv);
+    for (int i = 0; i < g_connections_len; i++) {
+        pthread_mutex_destroy(&send_mutexes[i]);
+    }
     pthread_mutex_destroy(&lifecycle_mutex);
     pthread_cond_destroy(&lifecycle_cv);
+    pthread_mutex_destroy(&reconnect_mutex);
 
+    log_pool_stats();
     LOGI("关闭完成");
     return 0;
-}
\ No newline at end of file
+}
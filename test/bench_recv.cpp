@@ -0,0 +1,229 @@
+/**
+ * bench_recv.cpp
+ * Encoding: UTF-8
+ *
+ * 接收路径的微基准测试，对比每条电文后的缓冲重置开销。
+ * - legacy: 旧实现，先读电文头再读电文体，每条电文处理完后 memset 整个 ReceiveBuffer。
+ * - ring:   当前实现，RecvRing 一次填充多条电文并原地解析，重置只移动读写偏移。
+ * 多个连接轮流接收小电文，模拟连接缓冲之间相互驱逐缓存的情况。
+ * 统计每条电文的耗时、写入内存的字节数（带宽）以及缓存未命中次数（需要 perf_event 权限）。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <vector>
+
+#include "../include/msghead.h"
+#include "../include/recv_ring.h"
+
+// --- 配置 ---
+#define MAX_MESSAGE_SIZE 9999
+#define BUFFER_SIZE (64 * 1024)
+#define NUM_CONNS 64            // 轮流接收的连接数
+#define BODY_LEN 10             // 小电文的电文体长度
+#define MSGS_PER_CONN 20000     // 每个连接接收的电文数
+#define RECV_CHUNK 4096         // 模拟每次 recv() 最多返回的字节数
+
+/**
+ * @struct LegacyReceiveBuffer
+ * @brief 旧实现的接收缓冲
+ */
+struct LegacyReceiveBuffer {
+    char data[MAX_MESSAGE_SIZE];
+    int received_bytes;
+    int expected_length;
+    bool header_received;
+};
+
+/**
+ * @struct Stream
+ * @brief 模拟的套接字，从预先生成的字节流中按 recv() 语义读取
+ */
+struct Stream {
+    const char* data;
+    size_t len;
+    size_t pos;
+    int recv(char* buf, int want) {
+        size_t n = len - pos;
+        if (n > (size_t)want) n = want;
+        memcpy(buf, data + pos, n);
+        pos += n;
+        return (int)n;
+    }
+};
+
+static volatile unsigned long long g_sink = 0;
+
+/**
+ * @brief 模拟业务处理，防止编译器优化掉电文体
+ */
+static inline void process_message(const char* data, int length) {
+    g_sink += (unsigned char)data[0] + (unsigned char)data[length - 1] + length;
+}
+
+/**
+ * @brief 旧实现：每条电文两次读取，处理后 memset 整个缓冲
+ * @return 写入内存的字节数（recv 拷贝 + memset）
+ */
+static unsigned long long run_legacy(std::vector<LegacyReceiveBuffer>& rbs, std::vector<Stream>& streams) {
+    unsigned long long written = 0;
+    int head_len = MsgHead::get_head_length();
+    bool pending = true;
+    while (pending) {
+        pending = false;
+        for (int c = 0; c < NUM_CONNS; c++) {
+            Stream& s = streams[c];
+            LegacyReceiveBuffer* rb = &rbs[c];
+            // 每个连接每轮处理一次 RECV_CHUNK 字节的数据，与 ring 的轮转粒度一致
+            size_t budget_end = s.pos + RECV_CHUNK;
+            while (s.pos < s.len && s.pos < budget_end) {
+                int bytes_to_read = rb->header_received ? rb->expected_length - rb->received_bytes
+                                                        : head_len - rb->received_bytes;
+                int n = s.recv(rb->data + rb->received_bytes, bytes_to_read);
+                written += n;
+                rb->received_bytes += n;
+                if (!rb->header_received && rb->received_bytes >= head_len) {
+                    rb->expected_length = ((MsgHead*)rb->data)->get_body_length();
+                    rb->header_received = true;
+                    rb->received_bytes = 0;
+                } else if (rb->header_received && rb->received_bytes >= rb->expected_length) {
+                    process_message(rb->data, rb->expected_length);
+                    memset(rb, 0, sizeof(LegacyReceiveBuffer));
+                    written += sizeof(LegacyReceiveBuffer);
+                }
+            }
+            if (s.pos < s.len) pending = true;
+        }
+    }
+    return written;
+}
+
+/**
+ * @brief 当前实现：一次读取尽可能多的数据，原地解析全部完整电文
+ * @return 写入内存的字节数（recv 拷贝 + 残余搬移）
+ */
+template <typename Ring>
+static unsigned long long run_ring(std::vector<Ring>& rbs, std::vector<Stream>& streams) {
+    unsigned long long written = 0;
+    int head_len = MsgHead::get_head_length();
+    bool pending = true;
+    while (pending) {
+        pending = false;
+        for (int c = 0; c < NUM_CONNS; c++) {
+            Stream& s = streams[c];
+            Ring* rb = &rbs[c];
+            if (s.pos < s.len) {
+                int old_head = rb->head;
+                rb->reserve(MAX_MESSAGE_SIZE);
+                if (old_head != 0 && rb->head == 0) written += rb->readable();   // 残余字节被搬移
+                int want = rb->writable() < RECV_CHUNK ? rb->writable() : RECV_CHUNK;
+                int n = s.recv(rb->write_ptr(), want);
+                written += n;
+                rb->commit(n);
+                while (rb->readable() >= head_len) {
+                    int body_len = ((MsgHead*)rb->read_ptr())->get_body_length();
+                    if (rb->readable() < head_len + body_len) break;
+                    process_message(rb->read_ptr() + head_len, body_len);
+                    rb->consume(head_len + body_len);
+                }
+            }
+            if (s.pos < s.len) pending = true;
+        }
+    }
+    return written;
+}
+
+/**
+ * @brief 打开硬件缓存未命中计数器
+ * @return int 成功返回描述符，无权限或不支持时返回 -1
+ */
+static int open_cache_miss_counter() {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief 运行一个场景并打印结果
+ */
+template <typename Fn>
+static void report(const char* name, Fn fn) {
+    int counter = open_cache_miss_counter();
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    double t0 = now_seconds();
+    unsigned long long written = fn();
+    double t1 = now_seconds();
+    long long misses = -1;
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counter, &misses, sizeof(misses)) != sizeof(misses)) misses = -1;
+        close(counter);
+    }
+
+    double msgs = (double)NUM_CONNS * MSGS_PER_CONN;
+    printf("%-8s %8.1f ns/msg  %9.1f B written/msg  %8.2f GB/s written  ",
+           name, (t1 - t0) * 1e9 / msgs, written / msgs, written / (t1 - t0) / 1e9);
+    if (misses >= 0) {
+        printf("%6.2f cache-misses/msg\n", misses / msgs);
+    } else {
+        printf("cache-misses n/a (perf_event 不可用)\n");
+    }
+}
+
+int main() {
+    // 生成每个连接的电文流
+    int head_len = MsgHead::get_head_length();
+    int frame_len = head_len + BODY_LEN;
+    std::vector<char> stream(frame_len * (size_t)MSGS_PER_CONN);
+    for (int i = 0; i < MSGS_PER_CONN; i++) {
+        char* p = &stream[(size_t)i * frame_len];
+        MsgHead head = {};
+        head.random_fill(BODY_LEN);
+        memcpy(p, &head, head_len);
+        memset(p + head_len, 'a' + i % 26, BODY_LEN);
+    }
+
+    std::vector<Stream> streams(NUM_CONNS);
+    auto rewind = [&]() {
+        for (int c = 0; c < NUM_CONNS; c++) {
+            streams[c].data = stream.data();
+            streams[c].len = stream.size();
+            streams[c].pos = 0;
+        }
+    };
+
+    printf("%d 个连接，每个连接 %d 条电文，电文体 %d 字节\n", NUM_CONNS, MSGS_PER_CONN, BODY_LEN);
+
+    std::vector<LegacyReceiveBuffer> legacy(NUM_CONNS);
+    memset(legacy.data(), 0, legacy.size() * sizeof(LegacyReceiveBuffer));
+    rewind();
+    report("legacy", [&]() { return run_legacy(legacy, streams); });
+
+    typedef RecvRing<BUFFER_SIZE> Ring;
+    std::vector<Ring> rings(NUM_CONNS);
+    for (auto& r : rings) r.reset();
+    rewind();
+    report("ring", [&]() { return run_ring(rings, streams); });
+
+    return g_sink == 0;
+}
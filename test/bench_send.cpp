@@ -0,0 +1,119 @@
+/**
+ * bench_send.cpp
+ * Encoding: UTF-8
+ *
+ * 发送缓冲链追加节点的微基准测试，对比不同积压深度下每次入队的耗时。
+ * - walk: 旧实现，每次追加都从链头遍历到链尾。
+ * - tail: 当前实现，即 include/send_chain.h 中的 append_send_buffer()，经每个连接的尾指针直接追加。
+ * 对端读得慢时缓冲链保持在固定深度：每追加一个节点就从链头发送（释放）一个节点。
+ * 两种实现的节点分配与电文头生成完全相同，这里只分配节点、不生成电文头，突出追加本身的开销。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/msghead.h"
+#include "../include/pool_alloc.h"
+#include "../include/send_chain.h"
+
+// --- 配置 ---
+#define APPENDS_PER_DEPTH 20000     // 每个积压深度下计时的追加次数
+#define MAX_WALK_WORK (1ULL << 28)  // 旧实现每个深度遍历的节点数上限，超过时减少追加次数
+
+// 默认电文头格式下 socket_comm.cpp 使用的发送缓冲链节点
+typedef SendBufferNode<MsgHead> SendBuffer;
+
+struct Chain {
+    SendBuffer* head;
+    SendBuffer* tail;
+};
+
+static SendBuffer* new_node() {
+    SendBuffer* b = (SendBuffer*)pool_alloc(sizeof(SendBuffer));
+    b->head_length = MsgHead::get_head_length();
+    b->body = NULL;
+    b->body_length = 10;
+    b->tail_length = 0;
+    b->total_length = b->head_length + b->body_length;
+    b->sent_bytes = 0;
+    b->release = NULL;
+    b->release_ctx = NULL;
+    b->next = NULL;
+    return b;
+}
+
+/**
+ * @brief 旧实现：从链头遍历到链尾后追加
+ */
+static void append_walk(Chain* c, SendBuffer* b) {
+    if (c->head == NULL) {
+        c->head = b;
+    } else {
+        SendBuffer* current = c->head;
+        while (current->next != NULL) {
+            current = current->next;
+        }
+        current->next = b;
+    }
+}
+
+/**
+ * @brief 当前实现：调用 socket_comm.cpp 使用的 append_send_buffer()
+ */
+static void append_tail(Chain* c, SendBuffer* b) {
+    append_send_buffer(&c->head, &c->tail, b);
+}
+
+/**
+ * @brief 从链头取下一个节点，模拟发送完毕
+ */
+static void pop_head(Chain* c) {
+    SendBuffer* b = c->head;
+    c->head = b->next;
+    if (c->head == NULL) c->tail = NULL;
+    pool_free(b);
+}
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief 在积压 depth 个节点的缓冲链上追加 appends 次，每次追加后释放链头，返回每次追加的纳秒数
+ */
+template <typename Append>
+static double run(int depth, int appends, Append append) {
+    Chain c = {NULL, NULL};
+    for (int i = 0; i < depth; i++) {
+        append_tail(&c, new_node());
+    }
+    double t0 = now_seconds();
+    for (int i = 0; i < appends; i++) {
+        append(&c, new_node());
+        pop_head(&c);
+    }
+    double t1 = now_seconds();
+    while (c.head != NULL) {
+        pop_head(&c);
+    }
+    return (t1 - t0) * 1e9 / appends;
+}
+
+int main() {
+    static const int depths[] = {1, 16, 256, 4096, 65536};
+    printf("%-10s %14s %14s %10s\n", "backlog", "walk ns/msg", "tail ns/msg", "speedup");
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+        int depth = depths[i];
+        int walk_appends = APPENDS_PER_DEPTH;
+        if ((unsigned long long)depth * walk_appends > MAX_WALK_WORK) {
+            walk_appends = (int)(MAX_WALK_WORK / depth);
+        }
+        double walk = run(depth, walk_appends, append_walk);
+        double tail = run(depth, APPENDS_PER_DEPTH, append_tail);
+        printf("%-10d %14.1f %14.1f %9.1fx\n", depth, walk, tail, walk / tail);
+    }
+    return 0;
+}
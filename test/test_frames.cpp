@@ -0,0 +1,347 @@
+/**
+ * test_frames.cpp
+ * Encoding: UTF-8
+ *
+ * 接收路径成帧的回归测试：把线路上的字节按不同的切分方式交给 feed_received_bytes()，
+ * 检查交给 process_received_message() 的电文体。
+ * 直接编译 socket_comm.cpp 的全部实现（其 main 改名后不调用），不建立套接字；
+ * 接收连接登记在 0 号反应器上但反应器线程不运行，process_received_message() 的回显留在连接的发送队列中，
+ * 测试从发送队列取出回显的消息即得到交付的电文体。
+ * - 默认电文头格式：分片的拼接、缺失或乱序的分片、未收完即以序号 0 重新开始、超过 FRAG_MAX_PENDING 条交错的分片消息。
+ * - 以 -DWIRE_HEAD_TRAITS=LineDelimitedTraits 编译时：分隔符模式下跨两次读取的电文、缺少分隔符的电文，
+ *   以及电文体中含有分隔符时发送接口拒绝入队。
+ * 全部通过时返回 0，否则打印失败的检查并返回 1。
+ */
+#define main socket_comm_main
+#include "../socket_comm.cpp"
+#undef main
+
+// 分隔符模式的用例与 -DWIRE_HEAD_TRAITS=LineDelimitedTraits 一起以 -DWIRE_HEAD_DELIMITED_TEST=1 选择
+#ifndef WIRE_HEAD_DELIMITED_TEST
+#define WIRE_HEAD_DELIMITED_TEST 0
+#endif
+static_assert(WireHead::delimited == (WIRE_HEAD_DELIMITED_TEST != 0), "WIRE_HEAD_DELIMITED_TEST 须与 WIRE_HEAD_TRAITS 一致");
+
+#define RECV_CONN 0     // 接收测试数据的连接
+#define ENCODE_CONN 1   // 只用于生成线路字节的连接，其发送缓冲链不写入套接字
+
+static int failures = 0;
+
+#define CHECK(cond, what) \
+    do { \
+        if (!(cond)) { \
+            failures++; \
+            printf("FAIL %s:%d %s\n", __FILE__, __LINE__, what); \
+        } \
+    } while (0)
+
+// 按 main() 的方式初始化测试用到的连接状态，接收连接交给 0 号反应器使回显能够入队
+static void init_test_state() {
+    for (int i = 0; i < g_connections_len; i++) {
+        receive_buffers[i].reset();
+        conn_reactors[i] = -1;
+        pthread_mutex_init(&send_mutexes[i], NULL);
+        pthread_cond_init(&send_space_cvs[i], NULL);
+        conn_send_queues[i].init();
+        build_head_template(i);
+        SendQueueLimits& limits = conn_send_limits[i];
+        limits.max_bytes = SEND_LIMIT_BYTES;
+        limits.max_msgs = SEND_LIMIT_MSGS;
+        limits.high_bytes = SEND_LIMIT_BYTES;
+        limits.high_msgs = SEND_LIMIT_MSGS;
+        limits.low_bytes = 0;
+        limits.low_msgs = 0;
+        limits.policy = OVERFLOW_FAIL;
+    }
+    g_reactor_count = 1;
+    reactors[0].id = 0;
+    reactors[0].wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    reactors[0].ready.init();
+    reactors[0].ready_signaled = false;
+    conn_reactors[RECV_CONN] = 0;
+}
+
+// 取出接收连接上回显的全部消息，拼接回显时再次拆分的分片，返回交付的电文体
+static std::vector<std::string> delivered() {
+    std::vector<std::string> bodies;
+    std::string pending;
+    Message batch[SEND_DRAIN_BATCH];
+    int n;
+    while ((n = conn_send_queues[RECV_CONN].pop_batch(batch, SEND_DRAIN_BATCH)) > 0) {
+        for (int i = 0; i < n; i++) {
+            pending.append(batch[i].data, batch[i].length);
+            if (!(batch[i].flags & MSG_FLAG_FRAGMENT) || (batch[i].flags & MSG_FLAG_LAST_FRAGMENT)) {
+                bodies.push_back(pending);
+                pending.clear();
+            }
+            release_send_space(RECV_CONN, message_wire_bytes(batch[i]), 1);
+            release_message(batch[i]);
+        }
+    }
+    conn_send_scheduled[RECV_CONN].store(false);
+    return bodies;
+}
+
+// 把 wire 按每段 step 字节依次交给 feed_received_bytes()，模拟多次读取；某次返回 false（断开连接）时返回 false
+static bool feed(const std::string& wire, size_t step) {
+    for (size_t offset = 0; offset < wire.size(); offset += step) {
+        size_t n = std::min(step, wire.size() - offset);
+        if (!feed_received_bytes(RECV_CONN, wire.data() + offset, (int)n)) return false;
+    }
+    return true;
+}
+
+// 模拟连接断开后重新建立，丢弃接收缓冲与重组状态
+static void reset_connection() {
+    receive_buffers[RECV_CONN].reset();
+    reset_reassembly(RECV_CONN);
+    delivered();
+}
+
+// 长度为 length 的电文体，内容随 seed 变化
+static std::string make_body(size_t length, int seed) {
+    std::string body(length, '\0');
+    for (size_t i = 0; i < length; i++) {
+        body[i] = (char)('A' + (i * 7 + seed) % 26);
+    }
+    return body;
+}
+
+#if !WIRE_HEAD_DELIMITED_TEST
+// 经发送路径（模板电文头、add_to_send_buffer()、gather_send_iov()）生成一条电文的线路字节
+// frag_id 不为 -1 时标记为分片消息 frag_id 共 chunks 片中的第 index 片
+static std::string encode(const std::string& body, int frag_id = -1, int index = 0, int chunks = 1) {
+    Message msg;
+    msg.length = (int)body.size();
+    msg.target_index = ENCODE_CONN;
+    msg.flags = 0;
+    msg.msgid[0] = '\0';
+    msg.data = (char*)pool_alloc(body.size());
+    memcpy(msg.data, body.data(), body.size());
+    msg.release = release_pool_body;
+    msg.release_ctx = NULL;
+    mark_fragment(&msg, frag_id, index, chunks);
+    add_to_send_buffer(ENCODE_CONN, msg);
+
+    std::string wire;
+    struct iovec iov[8];
+    size_t total;
+    int nodes;
+    int count = gather_send_iov(ENCODE_CONN, iov, 8, &total, &nodes);
+    for (int i = 0; i < count; i++) {
+        wire.append((const char*)iov[i].iov_base, iov[i].iov_len);
+    }
+    consume_sent_bytes(ENCODE_CONN, total);
+    return wire;
+}
+
+// 把 body 拆分为分片消息 frag_id 的各片，分别生成线路字节
+static std::vector<std::string> encode_fragments(const std::string& body, int frag_id) {
+    std::vector<std::string> frames;
+    int chunks = (int)((body.size() + MAX_MESSAGE_BODY_SIZE - 1) / MAX_MESSAGE_BODY_SIZE);
+    for (int i = 0; i < chunks; i++) {
+        size_t offset = (size_t)i * MAX_MESSAGE_BODY_SIZE;
+        std::string chunk = body.substr(offset, std::min((size_t)MAX_MESSAGE_BODY_SIZE, body.size() - offset));
+        frames.push_back(encode(chunk, frag_id, i, chunks));
+    }
+    return frames;
+}
+
+static int pending_reassemblies() {
+    int count = 0;
+    for (int i = 0; i < FRAG_MAX_PENDING; i++) {
+        if (reassemblies[RECV_CONN][i].active) count++;
+    }
+    return count;
+}
+
+static void test_plan_fragments() {
+    int chunks;
+    int frag_id;
+    CHECK(plan_fragments(MAX_MESSAGE_BODY_SIZE, &chunks, &frag_id) && chunks == 1 && frag_id == -1,
+          "不超过 MAX_MESSAGE_BODY_SIZE 的电文体不拆分");
+    CHECK(plan_fragments(MAX_MESSAGE_BODY_SIZE + 1, &chunks, &frag_id) && chunks == 2 && frag_id >= 0,
+          "超过 MAX_MESSAGE_BODY_SIZE 的电文体拆分为分片消息");
+    CHECK(plan_fragments((size_t)WireHead::max_fragments * MAX_MESSAGE_BODY_SIZE, &chunks, &frag_id) &&
+          chunks == WireHead::max_fragments, "恰好 max_fragments 片");
+    CHECK(!plan_fragments((size_t)WireHead::max_fragments * MAX_MESSAGE_BODY_SIZE + 1, &chunks, &frag_id),
+          "超过 max_fragments 片时失败");
+}
+
+// 按顺序到达的分片在任意切分下都交付一次完整的消息
+static void test_in_order() {
+    std::string body = make_body(MAX_MESSAGE_BODY_SIZE * 2 + 100, 1);
+    std::vector<std::string> frames = encode_fragments(body, 11);
+    std::string wire = frames[0] + frames[1] + frames[2];
+    static const size_t steps[] = {1, 7, 40, 4096, 65536};
+    for (size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); s++) {
+        CHECK(feed(wire, steps[s]), "按序的分片不应断开连接");
+        std::vector<std::string> got = delivered();
+        CHECK(got.size() == 1 && got[0] == body, "按序的分片重组为原消息");
+        CHECK(pending_reassemblies() == 0, "重组完成后不残留");
+    }
+
+    // 分片之间夹着普通电文：普通电文先交付，不影响重组
+    std::string small = make_body(30, 2);
+    CHECK(feed(frames[0] + encode(small) + frames[1] + frames[2], 13), "夹有普通电文");
+    std::vector<std::string> got = delivered();
+    CHECK(got.size() == 2 && got[0] == small && got[1] == body, "普通电文与分片消息各交付一次");
+}
+
+// 缺少中间的分片或分片乱序时丢弃整条消息，连接上的其他电文照常交付
+static void test_missing_and_out_of_order() {
+    std::string body = make_body(MAX_MESSAGE_BODY_SIZE * 2 + 1, 3);
+    std::vector<std::string> frames = encode_fragments(body, 12);
+    std::string small = make_body(10, 4);
+
+    CHECK(feed(frames[0] + frames[2] + encode(small), 100), "缺少分片不应断开连接");
+    std::vector<std::string> got = delivered();
+    CHECK(got.size() == 1 && got[0] == small, "缺少中间分片的消息被丢弃，其后的电文照常交付");
+    CHECK(pending_reassemblies() == 0, "缺少中间分片时不残留");
+
+    CHECK(feed(frames[0] + frames[2] + frames[1], 100), "乱序分片不应断开连接");
+    CHECK(delivered().empty(), "乱序的分片消息被丢弃，迟到的分片也被丢弃");
+    CHECK(pending_reassemblies() == 0, "乱序时不残留");
+
+    CHECK(feed(frames[1] + frames[2], 100), "没有首片的分片");
+    CHECK(delivered().empty(), "没有首片的分片被丢弃");
+}
+
+// 一条分片消息未收完时同一消息号以序号 0 重新开始：丢弃已收到的部分，按新的分片重组
+static void test_restart() {
+    std::string first = make_body(MAX_MESSAGE_BODY_SIZE * 2 + 5, 5);
+    std::string second = make_body(MAX_MESSAGE_BODY_SIZE + 9, 6);
+    std::vector<std::string> a = encode_fragments(first, 13);
+    std::vector<std::string> b = encode_fragments(second, 13);
+
+    CHECK(feed(a[0] + a[1], 500), "未收完的分片消息");
+    CHECK(delivered().empty() && pending_reassemblies() == 1, "缺少最后一片时等待");
+    CHECK(feed(b[0] + b[1], 500), "以序号 0 重新开始");
+    std::vector<std::string> got = delivered();
+    CHECK(got.size() == 1 && got[0] == second, "重新开始后只交付新的消息");
+    CHECK(pending_reassemblies() == 0, "重新开始后不残留");
+
+    CHECK(feed(a[2], 500), "旧消息迟到的最后一片");
+    CHECK(delivered().empty(), "旧消息迟到的最后一片被丢弃");
+}
+
+// 交错的分片消息各自重组；超过 FRAG_MAX_PENDING 条同时重组时丢弃最早开始的一条
+static void test_interleaved() {
+    std::string a = make_body(MAX_MESSAGE_BODY_SIZE * 2 + 3, 7);
+    std::string b = make_body(MAX_MESSAGE_BODY_SIZE + 3, 8);
+    std::vector<std::string> fa = encode_fragments(a, 21);
+    std::vector<std::string> fb = encode_fragments(b, 22);
+    CHECK(feed(fa[0] + fb[0] + fa[1] + fb[1] + fa[2], 333), "两条交错的分片消息");
+    std::vector<std::string> got = delivered();
+    CHECK(got.size() == 2 && got[0] == b && got[1] == a, "先收完的消息先交付");
+
+    const int groups = FRAG_MAX_PENDING + 1;
+    std::vector<std::string> bodies;
+    std::vector<std::vector<std::string> > frames;
+    std::string wire;
+    for (int g = 0; g < groups; g++) {
+        bodies.push_back(make_body(MAX_MESSAGE_BODY_SIZE + 50 + g, 9 + g));
+        frames.push_back(encode_fragments(bodies[g], 30 + g));
+        wire += frames[g][0];
+    }
+    for (int g = 0; g < groups; g++) {
+        wire += frames[g][1];
+    }
+    CHECK(feed(wire, 1000), "超过 FRAG_MAX_PENDING 条交错的分片消息");
+    got = delivered();
+    CHECK((int)got.size() == groups - 1, "最早开始的一条被淘汰，其余各条交付");
+    for (int g = 1; g < groups && g - 1 < (int)got.size(); g++) {
+        CHECK(got[g - 1] == bodies[g], "未被淘汰的消息按收完的顺序交付");
+    }
+    CHECK(pending_reassemblies() == 0, "淘汰与交付后不残留");
+}
+#else
+// 跨两次读取的电文在分隔符到达后交付一次，分隔符单独到达也可以
+static void test_split_frames() {
+    CHECK(feed("hel", 100) && feed("lo\n", 100), "跨两次读取的电文");
+    std::vector<std::string> got = delivered();
+    CHECK(got.size() == 1 && got[0] == "hello", "跨两次读取的电文交付一次");
+
+    CHECK(feed("abc", 100) && feed("\n", 100), "分隔符单独到达");
+    got = delivered();
+    CHECK(got.size() == 1 && got[0] == "abc", "分隔符单独到达时交付");
+
+    CHECK(feed("a\nbb\ncc", 100) && feed("c\n\n", 100), "一次读取含多条电文与半条电文");
+    got = delivered();
+    CHECK(got.size() == 3 && got[0] == "a" && got[1] == "bb" && got[2] == "ccc", "多条电文依次交付，空电文被忽略");
+
+    std::string body = make_body(MAX_MESSAGE_BODY_SIZE, 1);
+    CHECK(feed(body + "\n", 333), "最长的电文分多次到达");
+    got = delivered();
+    CHECK(got.size() == 1 && got[0] == body, "最长的电文交付一次");
+}
+
+// 缺少分隔符的电文不交付；超过 MAX_MESSAGE_BODY_SIZE 字节仍未出现分隔符时断开连接
+static void test_missing_terminator() {
+    CHECK(feed("no terminator", 100), "未出现分隔符时等待");
+    CHECK(delivered().empty(), "缺少分隔符的电文不交付");
+    reset_connection();
+
+    std::string body = make_body(MAX_MESSAGE_BODY_SIZE, 2);
+    CHECK(feed(body, 1000), "恰好 MAX_MESSAGE_BODY_SIZE 字节时仍等待分隔符");
+    CHECK(!feed("x", 1), "超过 MAX_MESSAGE_BODY_SIZE 字节仍未出现分隔符时断开连接");
+    CHECK(delivered().empty(), "超长的电文不交付");
+    reset_connection();
+
+    CHECK(!feed(make_body(MAX_MESSAGE_BODY_SIZE + 1, 3), 65536), "一次读取超长且无分隔符时断开连接");
+    reset_connection();
+
+    // 已成帧的电文须以分隔符结束
+    std::string framed = "abc";
+    CHECK(!add_to_send_queue_framed(RECV_CONN, std::string(framed)), "缺少分隔符的已成帧电文被拒绝");
+    CHECK(delivered().empty(), "被拒绝的已成帧电文不入队");
+}
+
+// 电文体中含有分隔符时各发送接口拒绝入队；线路上的分隔符总是结束一条电文
+static void test_delimiter_in_body() {
+    std::string body = "x\ny";
+    CHECK(!add_to_send_queue_std_string(RECV_CONN, body), "拷贝接口拒绝含分隔符的电文体");
+    CHECK(!add_to_send_queue_std_string(RECV_CONN, std::string(body)), "移交接口拒绝含分隔符的电文体");
+    char* data = (char*)pool_alloc(body.size());
+    memcpy(data, body.data(), body.size());
+    CHECK(!add_to_send_queue_buffer(RECV_CONN, data, body.size(), release_pool_body, NULL), "缓冲接口拒绝含分隔符的电文体");
+    const int targets[1] = {RECV_CONN};
+    CHECK(broadcast_send(targets, 1, body.data(), body.size()) == 0, "广播拒绝含分隔符的电文体");
+    CHECK(!add_to_send_queue_framed(RECV_CONN, std::string("x\ny\n")), "已成帧电文中间不能含分隔符");
+    CHECK(delivered().empty(), "被拒绝的电文体不入队");
+    SendQueueDepth depth;
+    get_send_queue_depth(RECV_CONN, &depth);
+    CHECK(depth.bytes == 0 && depth.msgs == 0, "被拒绝的电文体不占用额度");
+
+    CHECK(add_to_send_queue_std_string(RECV_CONN, std::string("xy")), "不含分隔符的电文体入队");
+    std::vector<std::string> got = delivered();
+    CHECK(got.size() == 1 && got[0] == "xy", "不含分隔符的电文体原样入队");
+
+    CHECK(feed("x\ny\n", 100), "线路上的分隔符");
+    got = delivered();
+    CHECK(got.size() == 2 && got[0] == "x" && got[1] == "y", "线路上的分隔符结束一条电文");
+}
+#endif
+
+int main() {
+    init_test_state();
+#if !WIRE_HEAD_DELIMITED_TEST
+    test_plan_fragments();
+    test_in_order();
+    test_missing_and_out_of_order();
+    test_restart();
+    test_interleaved();
+#else
+    test_split_frames();
+    test_missing_terminator();
+    test_delimiter_in_body();
+#endif
+    reset_connection();
+
+    if (failures > 0) {
+        printf("成帧测试失败：%d 项\n", failures);
+        return 1;
+    }
+    printf("成帧测试通过（%s）\n", WireHead::delimited ? "分隔符模式" : "默认电文头");
+    return 0;
+}
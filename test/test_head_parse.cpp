@@ -0,0 +1,141 @@
+/**
+ * test_head_parse.cpp
+ * Encoding: UTF-8
+ *
+ * include/msghead_parse.h 中电文头数字字段校验与解码的对照测试。
+ * - 合法电文头：SSE2、AVX2（CPU 支持时）与逐字符实现的解码结果一致，且等于按十进制逐位计算的期望值。
+ * - 数字字段中任一字节被改为 0 ~ 255 中的任一非数字值（包括紧邻 '0' ~ '9' 的 '/' 与 ':'）时，三种实现都拒绝。
+ * - 非数字字段（电文号、DC、备用字段）的任意取值不影响结果。
+ * 全部通过时返回 0，否则打印不一致的用例并返回 1。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/msghead_parse.h"
+
+// --- 配置 ---
+#define VALID_HEADS 2000        // 随机生成的合法电文头数
+#define CORRUPT_HEADS 20        // 逐字节篡改的电文头数
+
+struct Parser {
+    const char* name;
+    HeadParseFn fn;
+};
+
+static Parser parsers[3];
+static int parser_count = 0;
+static int failures = 0;
+
+static void init_parsers() {
+    parsers[parser_count++] = {"scalar", parse_head_scalar};
+#ifdef HEAD_PARSE_X86
+    parsers[parser_count++] = {"sse2", parse_head_sse2};
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        parsers[parser_count++] = {"avx2", parse_head_avx2};
+    } else {
+        printf("CPU 不支持 AVX2，跳过 avx2 实现\n");
+    }
+#endif
+}
+
+// 生成数字字段随机、其余字节为任意值的电文头
+static void random_head(char* head) {
+    for (int i = 0; i < HEAD_PARSE_BYTES; i++) {
+        if (HEAD_DIGIT_MASK >> i & 1) {
+            head[i] = (char)('0' + rand() % 10);
+        } else {
+            head[i] = (char)(rand() % 256);
+        }
+    }
+}
+
+// 按十进制逐位计算 [offset, offset + width) 的值
+static int decimal(const char* head, int offset, int width) {
+    int value = 0;
+    for (int i = 0; i < width; i++) {
+        value = value * 10 + (head[offset + i] - '0');
+    }
+    return value;
+}
+
+static bool same_fields(const HeadFields& a, const HeadFields& b) {
+    return a.length == b.length && a.date == b.date && a.time == b.time && a.seqno == b.seqno;
+}
+
+static void report(const char* what, const Parser& p, const char* head, int pos, int byte) {
+    if (++failures > 20) return;
+    printf("FAIL %s: %s 实现，位置 %d 字节 0x%02x，电文头 %.32s\n", what, p.name, pos, byte & 0xff, head);
+}
+
+// 合法电文头：各实现都接受，解码结果等于期望值
+static void check_valid(const char* head) {
+    HeadFields expected;
+    expected.length = decimal(head, HEAD_LENGTH_OFFSET, 4);
+    expected.date = decimal(head, HEAD_DATE_OFFSET, 8);
+    expected.time = decimal(head, HEAD_TIME_OFFSET, 6);
+    expected.seqno = decimal(head, HEAD_SEQNO_OFFSET, 6);
+    for (int k = 0; k < parser_count; k++) {
+        HeadFields out;
+        if (!parsers[k].fn(head, &out)) {
+            report("合法电文头被拒绝", parsers[k], head, -1, 0);
+        } else if (!same_fields(out, expected)) {
+            report("解码结果不一致", parsers[k], head, -1, 0);
+        }
+    }
+}
+
+// 把数字字段中的每个字节依次改为每个非数字值，各实现都须拒绝；非数字字段改为任意值时各实现仍须接受
+static void check_corruptions(const char* valid) {
+    char head[HEAD_PARSE_BYTES];
+    for (int pos = 0; pos < HEAD_PARSE_BYTES; pos++) {
+        bool digit = HEAD_DIGIT_MASK >> pos & 1;
+        for (int byte = 0; byte < 256; byte++) {
+            memcpy(head, valid, sizeof(head));
+            head[pos] = (char)byte;
+            bool is_digit = byte >= '0' && byte <= '9';
+            if (!digit || is_digit) {
+                check_valid(head);
+                continue;
+            }
+            for (int k = 0; k < parser_count; k++) {
+                HeadFields out;
+                if (parsers[k].fn(head, &out)) {
+                    report("非数字字节被接受", parsers[k], head, pos, byte);
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    srand(20260101);
+    init_parsers();
+
+    // 边界值：全 0 与全 9
+    char head[HEAD_PARSE_BYTES];
+    for (int fill = '0'; fill <= '9'; fill += 9) {
+        random_head(head);
+        for (int i = 0; i < HEAD_PARSE_BYTES; i++) {
+            if (HEAD_DIGIT_MASK >> i & 1) head[i] = (char)fill;
+        }
+        check_valid(head);
+        check_corruptions(head);
+    }
+    for (int n = 0; n < VALID_HEADS; n++) {
+        random_head(head);
+        check_valid(head);
+    }
+    for (int n = 0; n < CORRUPT_HEADS; n++) {
+        random_head(head);
+        check_corruptions(head);
+    }
+
+    if (failures > 0) {
+        printf("电文头解析测试失败：%d 处不一致\n", failures);
+        return 1;
+    }
+    printf("电文头解析测试通过：%d 种实现\n", parser_count);
+    return 0;
+}